@@ -1,13 +1,41 @@
 #version 410 core
 
-// Full-screen quad fragment shader.
-// Samples the watercolor simulation output texture and outputs it directly.
+// Screen tile fragment shader.
+// Composites the display mode from the raw field layers of one cached tile
+// (the vertex shader has already mapped the fragment into the tile, border
+// texels included). Matches Simulation::updateRenderBuffer on the CPU:
+// premultiplied pigment colour plus the uncovered share of the paper.
 in vec2 texCoord;
 
-uniform sampler2D tex;  // Watercolor RGB output (bound from Renderer::render)
+uniform int mode;  // DisplayMode of the tile's layers
+
+// Tile layers (RenderTiles.h TileLayer, bound from Renderer::drawTile)
+uniform sampler2D paperTex;    // R: paper shade
+uniform sampler2D surfaceTex;  // RGB: premultiplied surface colour, A: pigment
+uniform sampler2D depositTex;  // RGB: premultiplied deposit colour, A: deposit
+uniform sampler2D scalarTex;   // R: the field of a scalar display mode
 
 out vec4 out_Color;
 
+const int COMPOSITE       = 0;
+const int DEPOSIT         = 6;
+const int SURFACE_PIGMENT = 7;
+
 void main(void) {
-    out_Color = vec4(texture(tex, texCoord).rgb, 1.0);
+    vec3 color;
+    if (mode == COMPOSITE) {
+        vec4  surface = texture(surfaceTex, texCoord);
+        vec4  deposit = texture(depositTex, texCoord);
+        float paper   = texture(paperTex, texCoord).r;
+        color = deposit.rgb + surface.rgb + (1.0 - (deposit.a + surface.a)) * paper;
+    } else if (mode == DEPOSIT) {
+        vec4 deposit = texture(depositTex, texCoord);
+        color = deposit.rgb + (1.0 - deposit.a) * texture(paperTex, texCoord).r;
+    } else if (mode == SURFACE_PIGMENT) {
+        vec4 surface = texture(surfaceTex, texCoord);
+        color = surface.rgb + (1.0 - surface.a) * texture(paperTex, texCoord).r;
+    } else {
+        color = vec3(texture(scalarTex, texCoord).r);  // water, saturation, velocity, mask, evaporation
+    }
+    out_Color = vec4(color, 1.0);
 }
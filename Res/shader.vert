@@ -1,15 +1,21 @@
 #version 410 core
 
-// Full-screen quad vertex shader.
-// Passes texture coordinates to the fragment shader.
+// Screen tile vertex shader.
+// Places the unit quad over one tile's canvas rectangle as seen through the
+// current pan/zoom view, and maps its corners to the tile's texture rectangle.
 layout(location = 0) in vec3 in_Position;
 layout(location = 2) in vec2 in_TexCoord;
 
+uniform vec4 view;     // Canvas rectangle shown on screen (x, y, w, h in cells)
+uniform vec4 quad;     // Canvas rectangle drawn by this quad (x, y, w, h in cells)
+uniform vec4 texRect;  // Texture coordinates of the quad's corners (u0, v0, u1, v1)
+
 out vec2 texCoord;
 
 void main(void) {
-    gl_Position = vec4(in_Position, 1.0);
-    texCoord    = in_TexCoord;
+    // in_TexCoord is (0, 0) at the top-left corner; canvas y grows downwards
+    vec2 cell   = quad.xy + in_TexCoord * quad.zw;
+    vec2 ndc    = (cell - view.xy) / view.zw * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+    texCoord    = mix(texRect.xy, texRect.zw, in_TexCoord);
 }
-
-
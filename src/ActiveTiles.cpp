@@ -0,0 +1,136 @@
+//
+// ActiveTiles.cpp
+// WaterColorSimulation
+//
+// 활성 타일 집합 재구성
+//
+#include "ActiveTiles.h"
+
+#include <algorithm>
+#include <cstddef>
+
+void ActiveTiles::resize(int width, int height) {
+    m_width  = width;
+    m_height = height;
+    m_tilesX = (width  + k_tileSize - 1) / k_tileSize;
+    m_tilesY = (height + k_tileSize - 1) / k_tileSize;
+
+    const int count = m_tilesX * m_tilesY;
+    m_active   .assign(count, 0);
+    m_candidate.assign(count, 0);
+    m_wet      .assign(count, 0);
+    m_changed  .assign(count, 0);
+    m_changedList.clear();
+    m_rowSpans .assign(m_tilesY, {});
+    m_deactivated.clear();
+    m_activeCount = 0;
+    markAll();
+}
+
+void ActiveTiles::markAll() {
+    std::fill(m_candidate.begin(), m_candidate.end(), uint8_t(1));
+}
+
+void ActiveTiles::markRegion(int x0, int y0, int x1, int y1) {
+    const int tx0 = std::max(0, x0) / k_tileSize;
+    const int ty0 = std::max(0, y0) / k_tileSize;
+    const int tx1 = (std::min(m_width,  x1) + k_tileSize - 1) / k_tileSize;
+    const int ty1 = (std::min(m_height, y1) + k_tileSize - 1) / k_tileSize;
+    for (int ty = ty0; ty < ty1; ++ty)
+        for (int tx = tx0; tx < tx1; ++tx)
+            m_candidate[ty * m_tilesX + tx] = 1;
+}
+
+void ActiveTiles::markChanged(int x0, int y0, int x1, int y1) {
+    const int tx0 = std::max(0, x0) / k_tileSize;
+    const int ty0 = std::max(0, y0) / k_tileSize;
+    const int tx1 = (std::min(m_width,  x1) + k_tileSize - 1) / k_tileSize;
+    const int ty1 = (std::min(m_height, y1) + k_tileSize - 1) / k_tileSize;
+    for (int ty = ty0; ty < ty1; ++ty)
+        for (int tx = tx0; tx < tx1; ++tx)
+            markTileChanged(ty * m_tilesX + tx);
+}
+
+void ActiveTiles::markActiveChanged() {
+    if (m_activeCount == 0) return;
+    for (int t = 0; t < m_tilesX * m_tilesY; ++t)
+        if (m_active[t]) markTileChanged(t);
+}
+
+void ActiveTiles::markAllChanged() {
+    for (int t = 0; t < m_tilesX * m_tilesY; ++t) markTileChanged(t);
+}
+
+void ActiveTiles::rebuild(const float* wetAreaMask, const float* saturation, int stride,
+                          float saturationThreshold) {
+    // 1) 후보 타일만 검사해 젖은 셀이 있는 타일을 찾음
+    for (int ty = 0; ty < m_tilesY; ++ty) {
+        for (int tx = 0; tx < m_tilesX; ++tx) {
+            const int t = ty * m_tilesX + tx;
+            m_wet[t] = 0;
+            if (!m_candidate[t]) continue;
+
+            const int x0 = tx * k_tileSize, x1 = min(x0 + k_tileSize, m_width);
+            const int y0 = ty * k_tileSize, y1 = min(y0 + k_tileSize, m_height);
+            for (int y = y0; y < y1 && !m_wet[t]; ++y) {
+                const std::ptrdiff_t row = static_cast<std::ptrdiff_t>(y) * stride;
+                for (int x = x0; x < x1; ++x) {
+                    if (wetAreaMask[row + x] != 0.0f
+                        || saturation[row + x] > saturationThreshold) {
+                        m_wet[t] = 1;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // 2) 1타일 헤일로로 확장 → 새 활성 집합. 빠진 타일은 deactivated에 기록.
+    m_deactivated.clear();
+    m_activeCount = 0;
+    for (int ty = 0; ty < m_tilesY; ++ty) {
+        for (int tx = 0; tx < m_tilesX; ++tx) {
+            uint8_t active = 0;
+            for (int ny = std::max(0, ty - 1); ny <= std::min(m_tilesY - 1, ty + 1) && !active; ++ny)
+                for (int nx = std::max(0, tx - 1); nx <= std::min(m_tilesX - 1, tx + 1); ++nx)
+                    if (m_wet[ny * m_tilesX + nx]) { active = 1; break; }
+
+            const int t = ty * m_tilesX + tx;
+            if (m_active[t] && !active) m_deactivated.push_back(t);
+            m_active[t]    = active;
+            m_candidate[t] = active;
+            m_activeCount += active;
+        }
+    }
+
+    // 3) 타일 행마다 연속된 활성 타일을 하나의 셀 구간으로 병합
+    for (int ty = 0; ty < m_tilesY; ++ty) {
+        std::vector<Span>& spans = m_rowSpans[ty];
+        spans.clear();
+        for (int tx = 0; tx < m_tilesX; ++tx) {
+            if (!m_active[ty * m_tilesX + tx]) continue;
+            const int x0 = tx * k_tileSize;
+            const int x1 = min(x0 + k_tileSize, m_width);
+            if (!spans.empty() && spans.back().x1 == x0) spans.back().x1 = x1;
+            else                                         spans.push_back({ x0, x1 });
+        }
+    }
+}
+
+bool ActiveTiles::bounds(int& x0, int& y0, int& x1, int& y1) const {
+    if (m_activeCount == 0) return false;
+
+    int tx0 = m_tilesX, ty0 = m_tilesY, tx1 = -1, ty1 = -1;
+    for (int ty = 0; ty < m_tilesY; ++ty) {
+        for (int tx = 0; tx < m_tilesX; ++tx) {
+            if (!m_active[ty * m_tilesX + tx]) continue;
+            tx0 = std::min(tx0, tx); tx1 = std::max(tx1, tx);
+            ty0 = std::min(ty0, ty); ty1 = std::max(ty1, ty);
+        }
+    }
+    x0 = tx0 * k_tileSize;
+    y0 = ty0 * k_tileSize;
+    x1 = min((tx1 + 1) * k_tileSize, m_width);
+    y1 = min((ty1 + 1) * k_tileSize, m_height);
+    return true;
+}
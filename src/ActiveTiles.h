@@ -0,0 +1,118 @@
+//
+// ActiveTiles.h
+// WaterColorSimulation
+//
+// 희소 타일 스케줄링: 격자를 k_tileSize × k_tileSize 타일로 나누고
+// 젖은 셀(wetAreaMask 또는 확산 가능한 포화도)이 있는 타일 + 1타일 헤일로만
+// 활성으로 표시한다. 모든 서브스텝 커널은 활성 타일 위의 행 구간만 순회하므로
+// 스텝 비용이 캔버스 크기가 아닌 젖은 면적에 비례한다.
+//
+// 순회는 행 우선(같은 행의 활성 구간을 왼쪽부터)이므로 가우스-자이델처럼
+// 순서에 민감한 커널도 전체 격자 순회와 같은 순서로 셀을 방문한다.
+//
+// 같은 타일 단위로 "내용이 바뀐 타일"도 따로 모아 둔다 (화면 타일 캐시 무효화용).
+//
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class ActiveTiles {
+public:
+    static constexpr int k_tileSize = 32;
+
+    struct Span {
+        int x0;  // 포함
+        int x1;  // 제외
+    };
+
+    // 격자 크기에 맞게 타일 배열을 만들고 모든 타일을 후보로 표시
+    void resize(int width, int height);
+
+    // 모든 타일을 후보로 표시 (격자를 외부에서 직접 수정한 뒤 호출)
+    void markAll();
+
+    // 셀 사각형 [x0,x1) × [y0,y1)을 덮는 타일을 후보로 표시 (브러시 등)
+    void markRegion(int x0, int y0, int x1, int y1);
+
+    // 현재 후보 타일만 검사해 젖은 타일을 찾고, 헤일로 확장으로 활성 집합을 재구성.
+    // 젖음 판정: wetAreaMask != 0 또는 saturation > saturationThreshold.
+    // 두 포인터는 셀 (0, 0), stride는 행 간격 (패딩 격자 지원).
+    // 이번 재구성에서 비활성이 된 타일은 deactivated 목록에 담긴다.
+    void rebuild(const float* wetAreaMask, const float* saturation, int stride,
+                 float saturationThreshold);
+
+    // [yBegin,yEnd) × [xBegin,xEnd)와 겹치는 활성 구간마다 fn(y, x0, x1) 호출
+    template<typename Fn>
+    void forEachRow(int yBegin, int yEnd, int xBegin, int xEnd, Fn&& fn) const {
+        for (int y = yBegin; y < yEnd; ++y) {
+            for (const Span& span : m_rowSpans[y / k_tileSize]) {
+                const int x0 = span.x0 > xBegin ? span.x0 : xBegin;
+                const int x1 = span.x1 < xEnd   ? span.x1 : xEnd;
+                if (x0 < x1) fn(y, x0, x1);
+            }
+        }
+    }
+
+    // 방금 비활성이 된 타일의 셀 사각형마다 fn(x0, y0, x1, y1) 호출
+    template<typename Fn>
+    void forEachDeactivated(Fn&& fn) const {
+        for (int t : m_deactivated) {
+            const int tx = t % m_tilesX, ty = t / m_tilesX;
+            fn(tx * k_tileSize, ty * k_tileSize,
+               min((tx + 1) * k_tileSize, m_width),
+               min((ty + 1) * k_tileSize, m_height));
+        }
+    }
+
+    // --- 변경 기록 (활성 여부와 별개, takeChanged까지 누적) ---
+
+    // 셀 사각형 [x0,x1) × [y0,y1)을 덮는 타일을 변경됨으로 표시
+    void markChanged(int x0, int y0, int x1, int y1);
+
+    // 현재 활성 타일 전부 / 모든 타일을 변경됨으로 표시
+    void markActiveChanged();
+    void markAllChanged();
+
+    // 변경된 타일의 셀 사각형마다 fn(x0, y0, x1, y1) 호출 후 기록을 비움
+    template<typename Fn>
+    void takeChanged(Fn&& fn) {
+        for (int t : m_changedList) {
+            const int tx = t % m_tilesX, ty = t / m_tilesX;
+            fn(tx * k_tileSize, ty * k_tileSize,
+               min((tx + 1) * k_tileSize, m_width),
+               min((ty + 1) * k_tileSize, m_height));
+            m_changed[t] = 0;
+        }
+        m_changedList.clear();
+    }
+
+    // 활성 타일의 셀 단위 경계 상자. 활성 타일이 없으면 false.
+    bool bounds(int& x0, int& y0, int& x1, int& y1) const;
+
+    int activeCount() const { return m_activeCount; }
+    int tileCount()   const { return m_tilesX * m_tilesY; }
+
+private:
+    static int min(int a, int b) { return a < b ? a : b; }
+
+    void markTileChanged(int t) {
+        if (m_changed[t]) return;
+        m_changed[t] = 1;
+        m_changedList.push_back(t);
+    }
+
+    int m_width  = 0;
+    int m_height = 0;
+    int m_tilesX = 0;
+    int m_tilesY = 0;
+    int m_activeCount = 0;
+
+    std::vector<uint8_t>           m_active;    // 마지막 재구성 결과
+    std::vector<uint8_t>           m_candidate; // 다음 재구성 때 검사할 타일 (활성 ∪ 표시)
+    std::vector<uint8_t>           m_wet;       // 재구성 중 임시: 젖은 타일
+    std::vector<int>               m_deactivated;
+    std::vector<uint8_t>           m_changed;   // 변경 기록 (중복 방지 표시)
+    std::vector<int>               m_changedList;
+    std::vector<std::vector<Span>> m_rowSpans;  // 타일 행별 병합된 활성 구간 (셀 단위)
+};
@@ -0,0 +1,49 @@
+//
+// AlignedArena.cpp
+// WaterColorSimulation
+//
+// 정렬된 단일 블록 할당, THP 권고
+//
+#include "AlignedArena.h"
+
+#include <iostream>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+AlignedArena::~AlignedArena() {
+    release();
+}
+
+bool AlignedArena::allocate(size_t bytes, bool hugePages) {
+    release();
+    if (bytes == 0) return true;
+
+    // 대형 페이지는 블록 전체가 2MB 경계에 맞아야 커널이 묶을 수 있음
+    const size_t alignment = hugePages ? k_hugePageSize : k_alignment;
+    const size_t size      = (bytes + alignment - 1) / alignment * alignment;
+
+    m_data = ::operator new(size, std::align_val_t(alignment), std::nothrow);
+    if (!m_data) {
+        std::cerr << "[ERROR] Failed to allocate grid arena (" << (size >> 20) << " MB)\n";
+        return false;
+    }
+    m_bytes     = size;
+    m_alignment = alignment;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // 권고일 뿐이므로 실패(THP 비활성 커널 등)해도 일반 페이지로 계속
+    m_hugePages = hugePages && madvise(m_data, size, MADV_HUGEPAGE) == 0;
+#endif
+    return true;
+}
+
+void AlignedArena::release() {
+    if (!m_data) return;
+    ::operator delete(m_data, std::align_val_t(m_alignment));
+    m_data      = nullptr;
+    m_bytes     = 0;
+    m_hugePages = false;
+}
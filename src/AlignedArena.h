@@ -0,0 +1,42 @@
+//
+// AlignedArena.h
+// WaterColorSimulation
+//
+// 격자 버퍼 전체를 담는 단일 메모리 블록 (Grid가 평면 단위로 잘라 씀).
+// 시작 주소는 캐시 라인(64바이트) 경계. 대형 페이지를 요청하면 2MB 경계/배수로 할당하고
+// 투명 대형 페이지(THP)를 권고해 큰 격자에서 핫 루프의 TLB 미스를 줄인다 (Linux 전용,
+// 다른 플랫폼이나 커널이 거부하면 일반 페이지로 동작).
+//
+#pragma once
+
+#include <cstddef>
+
+class AlignedArena {
+public:
+    static constexpr size_t k_alignment    = 64;         // 바이트 (캐시 라인)
+    static constexpr size_t k_hugePageSize = 2u << 20;   // 바이트 (x86-64 THP)
+
+    AlignedArena() = default;
+    ~AlignedArena();
+
+    AlignedArena(const AlignedArena&)            = delete;
+    AlignedArena& operator=(const AlignedArena&) = delete;
+
+    // bytes 크기 블록 할당 (기존 블록은 해제, 내용은 초기화하지 않음).
+    // 실패 시 stderr에 출력하고 false.
+    bool allocate(size_t bytes, bool hugePages);
+
+    void release();
+
+    float* floats() const { return static_cast<float*>(m_data); }
+    size_t bytes()  const { return m_bytes; }
+
+    // 커널이 THP 권고를 받아들였는지
+    bool hugePages() const { return m_hugePages; }
+
+private:
+    void*  m_data      = nullptr;
+    size_t m_bytes     = 0;
+    size_t m_alignment = k_alignment;
+    bool   m_hugePages = false;
+};
@@ -0,0 +1,36 @@
+//
+// BrushMask.cpp
+// WaterColorSimulation
+//
+// 브러시 도장 가중치 마스크 구현
+//
+#include "BrushMask.h"
+
+#include <algorithm>
+#include <cmath>
+
+void BrushMask::update(int radius, float softness) {
+    radius   = std::max(0, radius);
+    softness = std::min(1.0f, std::max(0.0f, softness));
+    if (radius == m_radius && softness == m_softness) return;
+
+    m_radius   = radius;
+    m_softness = softness;
+    m_size     = 2 * radius + 1;
+    m_halfWidth.assign(m_size, -1);
+    m_weights.assign(static_cast<size_t>(m_size) * m_size, 0.0f);
+
+    const float r     = static_cast<float>(radius);
+    const float inner = (1.0f - softness) * r;
+    const int   r2    = radius * radius;
+    for (int dy = -radius; dy <= radius; ++dy) {
+        float* weights = m_weights.data() + (dy + radius) * m_size + radius;
+        for (int dx = 0; dx * dx + dy * dy < r2; ++dx) {
+            // 원판 판정은 정수 거리 제곱으로 (sqrt(d²) < r과 동일)
+            const float dist = std::sqrt(static_cast<float>(dx * dx + dy * dy));
+            const float w    = dist <= inner ? 1.0f : (r - dist) / (r - inner);
+            weights[dx] = weights[-dx] = w;
+            m_halfWidth[dy + radius] = dx;
+        }
+    }
+}
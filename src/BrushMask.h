@@ -0,0 +1,35 @@
+//
+// BrushMask.h
+// WaterColorSimulation
+//
+// 브러시 도장 가중치 마스크. 반경 r인 원판(dx² + dy² < r²)의 셀별 가중치를
+// (2r+1) × (2r+1) 표로 미리 계산해 두고, 반경/부드러움이 바뀔 때만 다시 만든다.
+// 도장 시에는 행별 원판 구간만 순회하므로 셀마다 sqrt를 하지 않는다.
+//
+// 가중치: 중심에서 (1 - softness) * r 까지 1, 그 밖은 원판 경계까지 선형 감쇠.
+// softness = 0이면 원판 전체가 1 (단단한 브러시).
+//
+#pragma once
+
+#include <vector>
+
+class BrushMask {
+public:
+    // radius/softness가 마지막 계산과 다를 때만 표를 다시 계산
+    void update(int radius, float softness);
+
+    int radius() const { return m_radius; }
+
+    // 행 dy ∈ [-radius, radius]의 원판 구간 반폭 (해당 행에 원판 셀이 없으면 -1)
+    int halfWidth(int dy) const { return m_halfWidth[dy + m_radius]; }
+
+    // 행 dy의 가중치 배열, 인덱스 dx + radius (|dx| <= halfWidth(dy)에서만 유효)
+    const float* row(int dy) const { return m_weights.data() + (dy + m_radius) * m_size; }
+
+private:
+    int                m_radius   = -1;
+    float              m_softness = -1.0f;
+    int                m_size     = 0;      // 2 * radius + 1
+    std::vector<int>   m_halfWidth;
+    std::vector<float> m_weights;
+};
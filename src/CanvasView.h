@@ -0,0 +1,95 @@
+//
+// CanvasView.h
+// WaterColorSimulation
+//
+// 캔버스(격자 셀)와 화면 뷰포트(픽셀) 사이의 변환 (이동/확대), 합성 출력 범위와 표시 모드.
+// 큰 캔버스는 전체를 합성/업로드하지 않고 뷰포트에 보이는 화면 타일만 (RenderTiles.h).
+//
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// 표시할 채널 (CPU 합성 Simulation::updateRenderBuffer, GPU 합성 shader.frag)
+enum class DisplayMode : int {
+    Composite      = 0,  // 최종 합성 (침착 + 수면 안료)
+    Water          = 1,  // 수면 물 양
+    Saturation     = 2,  // 모세관 포화도
+    VelocityX      = 3,  // 수평 속도
+    WetMask        = 4,  // 젖은 영역 마스크
+    Evaporation    = 5,  // 가우시안 블러된 경계 지시자
+    Deposit        = 6,  // 침착된 안료
+    SurfacePigment = 7,  // 수면 안료
+};
+
+// 렌더 출력 영역: 캔버스 셀 사각형 [x0,x1)×[y0,y1)를 step 셀마다 한 텍셀로 샘플링.
+// 출력은 width() × height() RGB 행 우선 배열. 캔버스 밖 텍셀은 가장자리 셀 값.
+struct RenderRegion {
+    int x0   = 0;
+    int y0   = 0;
+    int x1   = 0;
+    int y1   = 0;
+    int step = 1;
+
+    int width()  const { return (x1 - x0 + step - 1) / step; }
+    int height() const { return (y1 - y0 + step - 1) / step; }
+
+    // 출력 float 수 (RGB)
+    size_t floats() const { return 3 * static_cast<size_t>(width()) * height(); }
+
+    // 캔버스 전체를 셀마다 (헤드리스 이미지 저장용)
+    static RenderRegion full(int canvasW, int canvasH) { return { 0, 0, canvasW, canvasH, 1 }; }
+};
+
+// 뷰포트 픽셀 (px, py) → 캔버스 좌표 origin + (px, py) * cellsPerPixel (셀 단위, 왼쪽 위 원점)
+struct CanvasView {
+    glm::vec2  origin{ 0.0f };    // 뷰포트 왼쪽 위 모서리의 캔버스 좌표
+    float      cellsPerPixel = 1.0f;
+    glm::ivec2 viewport{ 0 };     // 뷰포트 크기 (픽셀)
+
+    bool operator==(const CanvasView& o) const {
+        return origin == o.origin && cellsPerPixel == o.cellsPerPixel && viewport == o.viewport;
+    }
+    bool operator!=(const CanvasView& o) const { return !(*this == o); }
+
+    // 캔버스 전체가 보이도록 (긴 변을 뷰포트에 맞추고 가운데 정렬)
+    static CanvasView fit(int canvasW, int canvasH, glm::ivec2 viewport) {
+        CanvasView view;
+        view.viewport      = viewport;
+        view.cellsPerPixel = std::max(static_cast<float>(canvasW) / viewport.x,
+                                      static_cast<float>(canvasH) / viewport.y);
+        view.origin = 0.5f * (glm::vec2(canvasW, canvasH) - glm::vec2(viewport) * view.cellsPerPixel);
+        return view;
+    }
+
+    // pixel 아래의 캔버스 점을 고정한 채 배율 변경
+    CanvasView zoomedAt(glm::vec2 pixel, float newCellsPerPixel) const {
+        CanvasView view    = *this;
+        view.cellsPerPixel = newCellsPerPixel;
+        view.origin        = toCanvas(pixel) - pixel * newCellsPerPixel;
+        return view;
+    }
+
+    // 뷰포트 중심을 유지한 채 배율 변경
+    CanvasView zoomedTo(float newCellsPerPixel) const {
+        return zoomedAt(0.5f * glm::vec2(viewport), newCellsPerPixel);
+    }
+
+    // 화면이 delta 픽셀만큼 끌려가도록 이동
+    CanvasView panned(glm::vec2 deltaPixels) const {
+        CanvasView view = *this;
+        view.origin    -= deltaPixels * cellsPerPixel;
+        return view;
+    }
+
+    // 뷰포트 중심이 캔버스 안에 머물도록 이동 (캔버스를 잃어버리지 않게)
+    CanvasView clampedTo(int canvasW, int canvasH) const {
+        CanvasView      view = *this;
+        const glm::vec2 half = 0.5f * glm::vec2(viewport) * cellsPerPixel;
+        view.origin = glm::clamp(origin + half, glm::vec2(0.0f), glm::vec2(canvasW, canvasH)) - half;
+        return view;
+    }
+
+    glm::vec2 toCanvas(glm::vec2 pixel) const { return origin + pixel * cellsPerPixel; }
+};
@@ -6,71 +6,147 @@
 //
 #include "Grid.h"
 
-Grid::Grid(int w, int h) : width(w), height(h) {}
+#include <algorithm>
 
-void Grid::init() {
-    const int total    = width * height;
-    const int totalRGB = 3 * total;
+#include "PerlinNoise.h"
+#include "ThreadPool.h"
 
-    // 모든 시뮬레이션 버퍼를 0으로 초기화
-    renderBuffer    .assign(totalRGB, 0.0f);
-    paper           .assign(totalRGB, 0.0f);
-    heightMap       .assign(total, 0.0f);
-    capacity        .assign(total, 0.0f);
+namespace {
 
-    water           .assign(total, 0.0f);
-    waterTemp       .assign(total, 0.0f);
-    velocity        .assign(total, glm::vec2(0.0f));
-    velocityTemp    .assign(total, glm::vec2(0.0f));
+constexpr int k_rowAlign = 8;  // float 단위 행 정렬 (AVX 폭)
 
-    wetAreaMask     .assign(total, 0.0f);
-    wetAreaMaskTemp .assign(total, 0.0f);
-    evaporation     .assign(total, 0.0f);
+// 병렬 초기화/유도 단위 (float 수, 1MB)
+constexpr size_t k_clearChunk = size_t(1) << 18;
 
-    saturation      .assign(total, 0.0f);
-    saturationTemp  .assign(total, 0.0f);
+// memoryReport 비교 기준: scratch 풀 이전에 필드마다 상주하던 임시 평면 수
+constexpr size_t k_baselineTempPlanes = 9;
 
-    pigment         .assign(total, 0.0f);
-    pigmentTemp     .assign(total, 0.0f);
-    pigmentDeposit  .assign(total, 0.0f);
+int alignUp(int n) { return (n + k_rowAlign - 1) / k_rowAlign * k_rowAlign; }
 
-    surfaceColor    .assign(total, glm::vec3(0.0f));
-    surfaceColorTemp.assign(total, glm::vec3(0.0f));
-    depositColor    .assign(total, glm::vec3(0.0f));
+} // anonymous namespace
 
-    pixelData       .resize(total);
+Grid::Grid(int w, int h, int haloWidth, bool hugePages)
+    : width(w), height(h), halo(std::max(1, haloWidth)),
+      padX(alignUp(halo)), stride(alignUp(padX + w + halo)),
+      m_requestHugePages(hugePages) {}
 
-    generateHeightMap();
+void Grid::layout(PlaneCursor& cursor) {
+    const size_t cells = cellCount();
 
-    // 렌더 버퍼를 흰색으로, 종이색/용량을 높이맵에서 유도
-    for (int i = 0; i < total; ++i) {
-        // 높이 봉우리일수록 약간 어둡게 (종이 질감 표현)
-        float shade = 1.0f - heightMap[i] * 0.05f;
-        paper[3 * i + 0] = shade;
-        paper[3 * i + 1] = shade;
-        paper[3 * i + 2] = shade;
+    heightMap.bind(cursor, cells);
+    capacity .bind(cursor, cells);
 
-        renderBuffer[3 * i + 0] = 1.0f;
-        renderBuffer[3 * i + 1] = 1.0f;
-        renderBuffer[3 * i + 2] = 1.0f;
+    m_scratchBegin = cursor.offset;
+    scratch.bind(cursor, k_scratchPlanes * PlaneCursor::pitch(cells));
 
-        wetAreaMask[i] = 0.0f;
+    m_stateBegin = cursor.offset;
+    water         .bind(cursor, cells);
+    velocity      .bind(cursor, cells);
+    wetAreaMask   .bind(cursor, cells);
+    evaporation   .bind(cursor, cells);
+    saturation    .bind(cursor, cells);
+    pigment       .bind(cursor, cells);
+    pigmentDeposit.bind(cursor, cells);
+    surfaceColor  .bind(cursor, cells);
+    depositColor  .bind(cursor, cells);
+    m_arenaFloats = cursor.offset;
+}
 
-        // 깊은 섬유(높이 낮음)일수록 물을 더 많이 흡수
-        capacity[i] = heightMap[i] * (0.7f - 0.2f) + 0.2f;
+bool Grid::init(ThreadPool* pool) {
+    if (!m_arena.floats()) {
+        // 배치를 한 번 돌려 크기를 잰 뒤 할당하고 실제 주소로 다시 bind
+        PlaneCursor measure;
+        layout(measure);
+        if (!m_arena.allocate(m_arenaFloats * sizeof(float), m_requestHugePages)) return false;
+        PlaneCursor cursor{ m_arena.floats() };
+        layout(cursor);
+
+        // 종이 구간의 유령/행 여백 셀도 정해진 값(0)으로 시작
+        clearArena(pool, 0, m_scratchBegin);
+        generateHeightMap(pool);
     }
+
+    // scratch와 상태는 평면 교환(ScratchPool)으로 섞이므로 함께 초기화
+    clearArena(pool, m_scratchBegin, m_arenaFloats);
+    return true;
+}
+
+Grid::MemoryReport Grid::memoryReport(int w, int h, int haloWidth) {
+    // 할당하지 않은 임시 격자에 크기 측정용 cursor로만 배치
+    Grid        probe(w, h, haloWidth, false);
+    PlaneCursor measure;
+    probe.layout(measure);
+
+    MemoryReport report;
+    report.paper   = probe.m_scratchBegin * sizeof(float);
+    report.scratch = (probe.m_stateBegin - probe.m_scratchBegin) * sizeof(float);
+    report.state   = (probe.m_arenaFloats - probe.m_stateBegin) * sizeof(float);
+    report.total   = probe.m_arenaFloats * sizeof(float);
+    report.baselineTemps = (k_baselineTempPlanes * PlaneCursor::pitch(probe.cellCount())
+                            + static_cast<size_t>(w) * h) * sizeof(float);
+    return report;
 }
 
-void Grid::generateHeightMap() {
+void Grid::reset(ThreadPool& pool) {
+    // 상태 평면은 scratch 슬롯과 맞바뀌어 scratch 구역에 있을 수 있음 → scratch + 상태
+    // (+ 정렬 여백)는 아레나에서 연속이므로 한 번의 채우기로 함께 초기화
+    clearArena(&pool, m_scratchBegin, m_arenaFloats);
+}
+
+void Grid::clearArena(ThreadPool* pool, size_t begin, size_t end) {
+    float* const base  = m_arena.floats();
+    const int    count = static_cast<int>((end - begin + k_clearChunk - 1) / k_clearChunk);
+    auto clear = [&](int first, int last) {
+        const size_t from = begin + static_cast<size_t>(first) * k_clearChunk;
+        const size_t to   = std::min(begin + static_cast<size_t>(last) * k_clearChunk, end);
+        std::fill(base + from, base + to, 0.0f);
+    };
+    if (pool) pool->parallelFor(0, count, clear);
+    else      clear(0, count);
+}
+
+void Grid::fillBorder(float* buffer) const {
+    // 좌우: 각 내부 행의 가장자리 값 복제
+    for (int y = 0; y < height; ++y) {
+        float* row = buffer + index(0, y);
+        std::fill(row - halo, row, row[0]);
+        std::fill(row + width, row + width + halo, row[width - 1]);
+    }
+    // 상하: 좌우가 채워진 첫/끝 행(유령 열 포함)을 복제
+    const int    span   = width + 2 * halo;
+    const float* top    = buffer + index(-halo, 0);
+    const float* bottom = buffer + index(-halo, height - 1);
+    for (int k = 1; k <= halo; ++k) {
+        std::copy(top,    top    + span, buffer + index(-halo, -k));
+        std::copy(bottom, bottom + span, buffer + index(-halo, height - 1 + k));
+    }
+}
+
+void Grid::generateHeightMap(ThreadPool* pool) {
     PerlinNoise noise;
 
-    int idx = 0;
-    for (int row = 0; row < height; ++row) {
-        for (int col = 0; col < width; ++col) {
-            double nx = static_cast<double>(col) / static_cast<double>(width);
-            double ny = static_cast<double>(row) / static_cast<double>(height);
-            // 고주파(200배) 노이즈로 종이 결 표현
-            heightMap[idx++] = static_cast<float>(noise.noise(200.0 * nx, 200.0 * ny, 0.0));
+    auto rows = [&](int rowBegin, int rowEnd) {
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            for (int col = 0; col < width; ++col) {
+                double nx = static_cast<double>(col) / static_cast<double>(width);
+                double ny = static_cast<double>(row) / static_cast<double>(height);
+                // 고주파(200배) 노이즈로 종이 결 표현
+                heightMap[index(col, row)] = static_cast<float>(noise.noise(200.0 * nx, 200.0 * ny, 0.0));
+            }
         }
-    }
+    };
+    if (pool) pool->parallelFor(0, height, rows);
+    else      rows(0, height);
+    fillBorder(heightMap.data());
+
+    // 깊은 섬유(높이 낮음)일수록 물을 더 많이 흡수 (유령 셀 포함)
+    const int count = static_cast<int>((capacity.size() + k_clearChunk - 1) / k_clearChunk);
+    auto derive = [&](int first, int last) {
+        const size_t from = static_cast<size_t>(first) * k_clearChunk;
+        const size_t to   = std::min(static_cast<size_t>(last) * k_clearChunk, capacity.size());
+        for (size_t i = from; i < to; ++i)
+            capacity[i] = heightMap[i] * (0.7f - 0.2f) + 0.2f;
+    };
+    if (pool) pool->parallelFor(0, count, derive);
+    else      derive(0, count);
 }
@@ -3,71 +3,129 @@
 // WaterColorSimulation
 //
 // 수채화 시뮬레이션의 모든 레이어를 보관하는 중심 데이터 구조
-// 버퍼는 행 우선(row-major) 1차원 배열: index = y * width + x
+// 시뮬레이션 버퍼는 사방 halo칸 이상의 유령 셀을 둔 행 우선 1차원 배열:
+//   index(x, y) = (y + halo) * stride + (x + padX)
+// 왼쪽 여백 padX와 stride는 8 float(32바이트) 배수로 맞춰 각 행의 x = 0이 벡터 경계에 오게 함.
+// 내부 루프는 클램프 없이 c ± 1, c ± stride로 이웃에 접근하고, 격자 밖을 읽는
+// 커널(이류 쌍선형 샘플링) 전에 fillBorder로 유령 셀을 가장자리 값으로 채운다.
+// 크기는 실행 시 결정 (16384² 이상도 가능하도록 인덱스는 64비트).
+// 합성 출력은 격자가 아닌 호출자 버퍼에 필요한 영역만 (Simulation::updateRenderBuffer).
+// 모든 버퍼는 64바이트 정렬된 단일 아레나의 평면 (필드 멤버는 비소유 뷰).
+// 벡터 필드(속도, 안료 색상)는 성분별 평면으로 저장 (PlanarField.h)
+// 이류/확산처럼 이전 값 전체를 읽는 커널의 출력은 필드별 임시 버퍼 대신 공용 scratch 구역의
+// 평면에 쓰고, 필드와 평면을 맞바꾸거나 활성 구간만 옮긴다 (Simulation의 ScratchPool).
+// 맞바꾼 뒤에는 상태 필드 평면이 scratch 구역에 있을 수 있다.
 //
 #pragma once
 
-#include <vector>
-#include <glm/glm.hpp>
+#include <cstddef>
 
-#include "KubelkaMunk.h"
-#include "PerlinNoise.h"
+#include "AlignedArena.h"
+#include "PlanarField.h"
+
+class ThreadPool;
 
 class Grid {
 public:
     const int width;   // 격자 열 수
     const int height;  // 격자 행 수
+    const int halo;    // 사방 유령 셀 폭 (>= 1)
+    const int padX;    // 왼쪽 여백 (halo를 8의 배수로 올림)
+    const int stride;  // 행 간격 (padX + width + halo를 8의 배수로 올림)
+
+    // 한 변 최대 셀 수. 평면 하나가 SimdKernels gather의 32비트 레인 인덱스 범위 안에 들도록.
+    static constexpr int k_maxSide = 16384;
+
+    // 서브스텝이 동시에 빌리는 최대 임시 평면 수: 안료 농도 + 색상 3성분 (확산 우변, 이류 출력)
+    static constexpr int k_scratchPlanes = 4;
 
-    // --- 출력 ---
-    std::vector<float> renderBuffer;   // RGB 합성 결과 (3 * width * height)
+    // --- 종이 (init 때 한 번 생성, reset에서 보존) ---
+    FloatPlane heightMap;  // 펄린 노이즈 높이맵 [0,1] (종이색은 paperShade로 유도)
+    FloatPlane capacity;   // 모세관 흡수 용량 (높이에서 파생)
 
-    // --- 종이 ---
-    std::vector<float> paper;      // 종이 기본색 RGB (3 * width * height)
-    std::vector<float> heightMap;  // 펄린 노이즈 높이맵 [0,1]
-    std::vector<float> capacity;   // 모세관 흡수 용량 (높이에서 파생)
+    // --- 작업 공간 (내용 보존 안 함) ---
+    // cellCount() 크기 평면 k_scratchPlanes개 (ScratchPool이 처음 빌릴 때 자름. 이후 슬롯은
+    // 상태 필드와 맞바뀌므로 이 구역 = 빌려줄 평면이 아님)
+    FloatPlane scratch;
 
     // --- 수면층 ---
-    std::vector<float>      water;        // 셀당 물 양
-    std::vector<float>      waterTemp;    // 이류 임시 버퍼
-    std::vector<glm::vec2>  velocity;     // 유체 속도 (u, v)
-    std::vector<glm::vec2>  velocityTemp; // 이류 임시 버퍼
+    FloatPlane water;     // 셀당 물 양
+    Vec2Field  velocity;  // 유체 속도 (u, v 평면)
 
     // --- 젖은 영역 마스크 ---
-    std::vector<float> wetAreaMask;     // 1 = 젖음, 0 = 건조
-    std::vector<float> wetAreaMaskTemp; // 임시 버퍼
-    std::vector<float> evaporation;     // 블러된 젖은 마스크 (경계 지시자)
+    FloatPlane wetAreaMask;  // 1 = 젖음, 0 = 건조
+    FloatPlane evaporation;  // 블러된 젖은 마스크 (경계 지시자)
 
     // --- 모세관층 ---
-    std::vector<float> saturation;     // 종이 섬유 흡수 포화도
-    std::vector<float> saturationTemp; // 확산 임시 버퍼
+    FloatPlane saturation;  // 종이 섬유 흡수 포화도
 
     // --- 안료 ---
-    std::vector<float> pigment;        // 수면층 안료 농도
-    std::vector<float> pigmentTemp;    // 이류 임시 버퍼
-    std::vector<float> pigmentDeposit; // 종이 표면에 침착된 안료 농도
+    FloatPlane pigment;         // 수면층 안료 농도
+    FloatPlane pigmentDeposit;  // 종이 표면에 침착된 안료 농도
 
     // 셀별 안료 색상 (사전 곱셈 저장: 실제색 × 농도)
     // 농도 스칼라와 분리 저장하여 여러 색상이 공존 가능
-    std::vector<glm::vec3> surfaceColor;      // 수면층 안료 색상
-    std::vector<glm::vec3> surfaceColorTemp;  // 이류 임시 버퍼
-    std::vector<glm::vec3> depositColor;      // 침착 안료 색상
+    Vec3Field surfaceColor;  // 수면층 안료 색상 (r, g, b 평면)
+    Vec3Field depositColor;  // 침착 안료 색상
 
-    // --- KM 픽셀 데이터 ---
-    std::vector<PixelInfo> pixelData;
+    // hugePages: 아레나에 투명 대형 페이지를 권고 (AlignedArena)
+    Grid(int w, int h, int haloWidth = 1, bool hugePages = true);
 
-    Grid(int w, int h);
+    // 첫 호출: 아레나 할당 + 종이 생성. 이후 호출은 종이를 재사용하고 상태만 초기화.
+    // pool이 있으면 종이 생성/초기화를 행 묶음으로 병렬 처리. 할당 실패 시 false.
+    bool init(ThreadPool* pool = nullptr);
 
-    // 모든 버퍼 할당 및 초기화. 여러 번 호출 가능 (리셋).
-    void init();
+    // 종이를 제외한 모든 상태(와 scratch)를 0으로 (pool로 병렬, 할당 없음). init 이후에만 호출.
+    void reset(ThreadPool& pool);
 
-    // (x, y)에 대한 클램프된 1차원 인덱스 반환
-    inline int index(int x, int y) const {
-        int cx = (x < 0) ? 0 : (x >= width  ? width  - 1 : x);
-        int cy = (y < 0) ? 0 : (y >= height ? height - 1 : y);
-        return cy * width + cx;
+    // (x, y)의 1차원 인덱스. x ∈ [-halo, width + halo), y ∈ [-halo, height + halo).
+    inline std::ptrdiff_t index(int x, int y) const {
+        return static_cast<std::ptrdiff_t>(y + halo) * stride + (x + padX);
     }
 
+    // 패딩 포함 시뮬레이션 버퍼 길이
+    size_t cellCount() const { return static_cast<size_t>(stride) * (height + 2 * halo); }
+
+    // 인덱스 i 셀의 종이 밝기 (높이 봉우리일수록 약간 어둡게, RGB 공통)
+    static constexpr float k_paperRelief = 0.05f;
+    float paperShade(std::ptrdiff_t i) const { return 1.0f - heightMap[i] * k_paperRelief; }
+
+    // 유령 셀을 가장 가까운 가장자리 셀 값으로 채움 (클램프 인덱스와 같은 값)
+    void fillBorder(float* buffer) const;
+
+    // 아레나 크기 (바이트), 대형 페이지 적용 여부
+    size_t arenaBytes()    const { return m_arena.bytes(); }
+    bool   usesHugePages() const { return m_arena.hugePages(); }
+
+    // 아레나 구역별 크기 (바이트, 할당 단위 올림 전)
+    struct MemoryReport {
+        size_t paper   = 0;  // heightMap, capacity
+        size_t scratch = 0;  // 임시 평면 구역
+        size_t state   = 0;  // 시뮬레이션 상태 필드
+        size_t total   = 0;
+        // 비교 기준: scratch 풀 도입 전 필드별 상주 임시 평면 9장
+        // (water, velocity×2, saturation, pigment, surfaceColor×3, wetAreaMask)
+        // + 블러용 w × h 벡터. 같은 배치(pitch)로 계산
+        size_t baselineTemps = 0;
+    };
+
+    // w × h 격자의 배치만 계산 (할당 없음, 기존 격자에 영향 없음)
+    static MemoryReport memoryReport(int w, int h, int haloWidth = 1);
+
 private:
-    // 높이맵을 펄린 노이즈로 채우고 종이색/용량을 유도
-    void generateHeightMap();
+    // 모든 필드를 cursor에서 차례로 bind (base == nullptr이면 크기만 계산).
+    // 종이 → scratch → 상태 순서이므로 scratch + 상태는 [m_scratchBegin, 끝) 한 구간.
+    void layout(PlaneCursor& cursor);
+
+    // 아레나 [begin, end) float 구간을 0으로 (pool이 nullptr이면 호출 스레드에서)
+    void clearArena(ThreadPool* pool, size_t begin, size_t end);
+
+    // 높이맵을 펄린 노이즈로 채우고 용량을 유도 (행마다 독립 → 병렬이어도 같은 결과)
+    void generateHeightMap(ThreadPool* pool);
+
+    const bool   m_requestHugePages;
+    AlignedArena m_arena;
+    size_t       m_scratchBegin = 0;  // float 단위 아레나 오프셋
+    size_t       m_stateBegin   = 0;
+    size_t       m_arenaFloats  = 0;
 };
@@ -0,0 +1,69 @@
+//
+// ImageWriter.cpp
+// WaterColorSimulation
+//
+// PPM / PFM 이미지 저장
+//
+#include "ImageWriter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+    if (s.size() < suffix.size()) return false;
+    for (size_t i = 0; i < suffix.size(); ++i) {
+        char a = s[s.size() - suffix.size() + i];
+        if (a >= 'A' && a <= 'Z') a = static_cast<char>(a - 'A' + 'a');
+        if (a != suffix[i]) return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+bool writeImage(const std::string& path, const float* rgb, int width, int height) {
+    if (endsWith(path, ".pfm")) return writePFM(path, rgb, width, height);
+    if (endsWith(path, ".ppm")) return writePPM(path, rgb, width, height);
+    std::cerr << "[ERROR] Unsupported image extension (use .ppm or .pfm): " << path << "\n";
+    return false;
+}
+
+bool writePPM(const std::string& path, const float* rgb, int width, int height) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[ERROR] Cannot write image: " << path << "\n";
+        return false;
+    }
+    file << "P6\n" << width << " " << height << "\n255\n";
+
+    std::vector<unsigned char> row(3 * static_cast<size_t>(width));
+    for (int y = 0; y < height; ++y) {
+        const float* src = rgb + 3 * static_cast<size_t>(y) * width;
+        for (size_t i = 0; i < row.size(); ++i) {
+            const float v = std::min(1.0f, std::max(0.0f, src[i]));
+            row[i] = static_cast<unsigned char>(v * 255.0f + 0.5f);
+        }
+        file.write(reinterpret_cast<const char*>(row.data()),
+                   static_cast<std::streamsize>(row.size()));
+    }
+    return static_cast<bool>(file);
+}
+
+bool writePFM(const std::string& path, const float* rgb, int width, int height) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[ERROR] Cannot write image: " << path << "\n";
+        return false;
+    }
+    // 음수 스케일 = 리틀 엔디언. PFM은 아래 행부터 저장.
+    file << "PF\n" << width << " " << height << "\n-1.0\n";
+    for (int y = height - 1; y >= 0; --y) {
+        file.write(reinterpret_cast<const char*>(rgb + 3 * static_cast<size_t>(y) * width),
+                   static_cast<std::streamsize>(3 * sizeof(float) * width));
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,17 @@
+//
+// ImageWriter.h
+// WaterColorSimulation
+//
+// GL 없이 합성 결과(Simulation::updateRenderBuffer)를 이미지 파일로 저장 (헤드리스 실행용)
+//
+#pragma once
+
+#include <string>
+
+// RGB float 버퍼(3 * width * height, 행 우선, [0,1])를 저장.
+// 확장자로 형식 결정: .ppm → 8비트 바이너리 PPM(P6), .pfm → 32비트 float PFM.
+// 실패 시 stderr에 출력하고 false 반환.
+bool writeImage(const std::string& path, const float* rgb, int width, int height);
+
+bool writePPM(const std::string& path, const float* rgb, int width, int height);
+bool writePFM(const std::string& path, const float* rgb, int width, int height);
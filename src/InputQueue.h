@@ -0,0 +1,81 @@
+//
+// InputQueue.h
+// WaterColorSimulation
+//
+// GLFW 입력 콜백(생산자)과 시뮬레이션(소비자) 사이의 단일 생산자/단일 소비자
+// 무잠금 링 버퍼. 콜백마다 시각이 찍힌 이벤트를 하나씩 넣으므로 프레임 사이의
+// 중간 커서 표본이 사라지지 않고, 소비자는 서브스텝 시간 구간별로 꺼내 쓴다.
+//
+// 생산자/소비자 인덱스는 서로 다른 캐시 라인에 두고, 상대 인덱스는 각자 캐시해
+// 큐가 가득/비었을 때만 원자 변수를 다시 읽는다.
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+// 입력 이벤트와 시뮬레이션 시간 구간이 공유하는 시계 (초, 단조 증가, 모든 스레드에서 호출 가능)
+inline double inputClock() {
+    using Seconds = std::chrono::duration<double>;
+    return std::chrono::duration_cast<Seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 캔버스 포인터 입력 (좌표는 캔버스 기준 정규화 [0,1])
+struct InputEvent {
+    enum class Type : int {
+        Move    = 0,  // 커서 이동
+        Press   = 1,  // 왼쪽 버튼 누름
+        Release = 2,  // 왼쪽 버튼 뗌
+    };
+
+    Type   type  = Type::Move;
+    double time  = 0.0;   // inputClock() 기준 초. GLFW는 OS 이벤트 시각을 주지 않으므로 전달 시각.
+    float  normX = 0.0f;
+    float  normY = 0.0f;
+};
+
+class InputQueue {
+public:
+    static constexpr size_t k_capacity = 1024;  // 2의 거듭제곱 (60Hz 기준 수 초 분량의 이동 표본)
+
+    // 생산자 전용. 가득 차면 false (콜백은 막히면 안 되므로 이벤트를 버림).
+    bool push(const InputEvent& event) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache == k_capacity) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache == k_capacity) return false;
+        }
+        m_events[tail & (k_capacity - 1)] = event;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 소비자 전용. 가장 오래된 이벤트 (없으면 nullptr), pop() 전까지 유효.
+    const InputEvent* front() {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache) return nullptr;
+        }
+        return &m_events[head & (k_capacity - 1)];
+    }
+
+    // 소비자 전용. front()가 돌려준 이벤트를 제거.
+    void pop() {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    // 소비자 쪽: 읽기 인덱스 + 마지막으로 본 쓰기 인덱스
+    alignas(64) std::atomic<size_t> m_head{ 0 };
+    size_t                          m_tailCache = 0;
+
+    // 생산자 쪽: 쓰기 인덱스 + 마지막으로 본 읽기 인덱스
+    alignas(64) std::atomic<size_t> m_tail{ 0 };
+    size_t                          m_headCache = 0;
+
+    alignas(64) std::array<InputEvent, k_capacity> m_events{};
+};
@@ -0,0 +1,246 @@
+//
+// Multigrid.cpp
+// WaterColorSimulation
+//
+// 마스크 적용 V-사이클 멀티그리드 구현
+//
+#include "Multigrid.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace {
+
+constexpr int   k_preSmooth     = 2;     // V-사이클 전/후 적색-흑색 반복 수
+constexpr int   k_postSmooth    = 2;
+constexpr int   k_coarseSweeps  = 8;     // 가장 조대한 수준의 반복 수
+constexpr float k_minCoarseA    = 0.05f; // a가 이보다 작으면 평활만으로 충분 → 조대화 중단
+constexpr int   k_minCoarseSize = 8;     // 이보다 작은 수준은 만들지 않음
+
+inline void atomicMax(std::atomic<float>& target, float value) {
+    float current = target.load(std::memory_order_relaxed);
+    while (value > current
+           && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+} // anonymous namespace
+
+template<int N>
+int Multigrid<N>::solve(PlaneSet<N> field, ConstPlaneSet<N> rhs, const float* mask, int stride,
+                        int x0, int y0, int x1, int y1,
+                        float a, float threshold, int maxCycles,
+                        const SimdKernels& kernels, ThreadPool& pool, float& residual) {
+    residual = 0.0f;
+    if (x1 <= x0 || y1 <= y0) return 0;
+
+    const std::ptrdiff_t origin = static_cast<std::ptrdiff_t>(y0) * stride + x0;
+    m_kernels = &kernels;
+    m_fine    = { {}, {}, mask + origin, stride, x1 - x0, y1 - y0, a };
+    for (int c = 0; c < N; ++c) {
+        m_fine.u[c] = field[c] + origin;
+        m_fine.b[c] = rhs[c]   + origin;
+    }
+    buildLevels(a, pool);
+
+    int cycles = 0;
+    while (cycles < std::max(1, maxCycles)) {
+        ++cycles;
+        residual = vcycle(0, pool);
+        if (residual <= threshold) break;
+    }
+    return cycles;
+}
+
+template<int N>
+typename Multigrid<N>::View Multigrid<N>::view(int level) {
+    return level == 0 ? m_fine : m_levels[level - 1].view();
+}
+
+// 조대 수준 구성: 크기/a/마스크 (마스크는 풀이 동안 변하지 않음)
+template<int N>
+void Multigrid<N>::buildLevels(float a, ThreadPool& pool) {
+    m_levelCount = 1;
+    View fine = m_fine;
+    while (a >= k_minCoarseA
+           && std::min(fine.width, fine.height) >= 2 * k_minCoarseSize) {
+        if (static_cast<int>(m_levels.size()) < m_levelCount) m_levels.emplace_back();
+        Level& level = m_levels[m_levelCount - 1];
+        level.width  = (fine.width  + 1) / 2;
+        level.height = (fine.height + 1) / 2;
+        level.a      = (a *= 0.25f);
+
+        const size_t cells = static_cast<size_t>(level.stride()) * (level.height + 2);
+        for (int c = 0; c < N; ++c) {
+            level.u[c].resize(cells);
+            level.b[c].resize(cells);
+        }
+        level.mask.assign(cells, 0.0f);
+
+        View coarse = level.view();
+        float* cmask = level.mask.data() + level.stride() + 1;
+        pool.parallelFor(0, coarse.height, [&](int yBegin, int yEnd) {
+            for (int cy = yBegin; cy < yEnd; ++cy) {
+                for (int cx = 0; cx < coarse.width; ++cx) {
+                    float wet = 0.0f;
+                    for (int j = 0; j < 2; ++j) {
+                        const int fy = 2 * cy + j;
+                        if (fy >= fine.height) break;
+                        for (int i = 0; i < 2; ++i) {
+                            const int fx = 2 * cx + i;
+                            if (fx < fine.width && fine.mask[fy * fine.stride + fx]) wet = 1.0f;
+                        }
+                    }
+                    cmask[cy * coarse.stride + cx] = wet;
+                }
+            }
+        });
+
+        fine = coarse;
+        ++m_levelCount;
+    }
+}
+
+// 반환: level 0에서는 전평활 후 미세 격자 max 잔차, 그 외에는 0
+template<int N>
+float Multigrid<N>::vcycle(int level, ThreadPool& pool) {
+    const View v = view(level);
+
+    if (level == m_levelCount - 1) {
+        if (level == 0) {
+            // 조대 수준이 없으면 평활만 하고 잔차 측정
+            smooth(v, k_preSmooth + k_postSmooth, pool);
+            return residualNorm(v, pool);
+        }
+        smooth(v, k_coarseSweeps, pool);
+        return 0.0f;
+    }
+
+    smooth(v, k_preSmooth, pool);
+
+    Level& coarse = m_levels[level];
+    const float residual = restrictResidual(v, coarse, pool);
+    for (AlignedFloats& plane : coarse.u)  // 보정량 초기값 + 유령 셀 0
+        std::fill(plane.begin(), plane.end(), 0.0f);
+    vcycle(level + 1, pool);
+    prolongate(coarse, v, pool);
+
+    smooth(v, k_postSmooth, pool);
+    return residual;
+}
+
+template<int N>
+void Multigrid<N>::smooth(const View& v, int iterations, ThreadPool& pool) {
+    const float diag = 1.0f + 4.0f * v.a;
+    const int   s    = v.stride;
+    for (int iter = 0; iter < iterations; ++iter) {
+        for (int colour = 0; colour < 2; ++colour) {
+            pool.parallelFor(0, v.height, [&](int yBegin, int yEnd) {
+                float*       u[N];
+                const float* b[N];
+                for (int y = yBegin; y < yEnd; ++y) {
+                    const std::ptrdiff_t row = static_cast<std::ptrdiff_t>(y) * s;
+                    for (int c = 0; c < N; ++c) {
+                        u[c] = v.u[c] + row;
+                        b[c] = v.b[c] + row;
+                    }
+                    m_kernels->diffuseRow(u, b, N, v.mask + row, s, 0, v.width,
+                                          (y + colour) & 1, v.a, diag);
+                }
+            });
+        }
+    }
+}
+
+template<int N>
+float Multigrid<N>::residualNorm(const View& v, ThreadPool& pool) {
+    const float diag = 1.0f + 4.0f * v.a;
+    const int   s    = v.stride;
+    std::atomic<float> norm{ 0.0f };
+    pool.parallelFor(0, v.height, [&](int yBegin, int yEnd) {
+        float local = 0.0f;
+        for (int y = yBegin; y < yEnd; ++y) {
+            for (int x = 0; x < v.width; ++x) {
+                const std::ptrdiff_t i = static_cast<std::ptrdiff_t>(y) * s + x;
+                if (!v.mask[i]) continue;
+                for (int c = 0; c < N; ++c) {
+                    const float* u = v.u[c];
+                    const float  r = v.b[c][i] - (diag * u[i] - v.a * (u[i - 1] + u[i + 1]
+                                                                       + u[i - s] + u[i + s]));
+                    local = std::max(local, std::abs(r));
+                }
+            }
+        }
+        atomicMax(norm, local);
+    });
+    return norm.load();
+}
+
+// 미세 잔차를 계산하며 곧바로 2×2 평균으로 조대 우변에 기록. 반환: 미세 max 잔차.
+template<int N>
+float Multigrid<N>::restrictResidual(const View& fine, Level& coarse, ThreadPool& pool) {
+    const float diag = 1.0f + 4.0f * fine.a;
+    const int   s    = fine.stride;
+    const int   cs   = coarse.stride();
+    float*      cb[N];
+    for (int c = 0; c < N; ++c) cb[c] = coarse.b[c].data() + cs + 1;
+    std::atomic<float> norm{ 0.0f };
+    pool.parallelFor(0, coarse.height, [&](int yBegin, int yEnd) {
+        float local = 0.0f;
+        for (int cy = yBegin; cy < yEnd; ++cy) {
+            for (int cx = 0; cx < coarse.width; ++cx) {
+                float sum[N] = {};
+                for (int j = 0; j < 2; ++j) {
+                    const int fy = 2 * cy + j;
+                    if (fy >= fine.height) break;
+                    for (int i = 0; i < 2; ++i) {
+                        const int fx = 2 * cx + i;
+                        const std::ptrdiff_t f = static_cast<std::ptrdiff_t>(fy) * s + fx;
+                        if (fx >= fine.width || !fine.mask[f]) continue;
+                        for (int c = 0; c < N; ++c) {
+                            const float* u = fine.u[c];
+                            const float  r = fine.b[c][f]
+                                - (diag * u[f] - fine.a * (u[f - 1] + u[f + 1] + u[f - s] + u[f + s]));
+                            local   = std::max(local, std::abs(r));
+                            sum[c] += r;
+                        }
+                    }
+                }
+                for (int c = 0; c < N; ++c) cb[c][cy * cs + cx] = 0.25f * sum[c];
+            }
+        }
+        atomicMax(norm, local);
+    });
+    return norm.load();
+}
+
+// 조대 보정량을 셀 중심 쌍선형으로 보간해 젖은 미세 셀에 더함
+template<int N>
+void Multigrid<N>::prolongate(Level& coarse, const View& fine, ThreadPool& pool) {
+    const View cv = coarse.view();
+    const int  cs = cv.stride;
+    pool.parallelFor(0, fine.height, [&](int yBegin, int yEnd) {
+        for (int y = yBegin; y < yEnd; ++y) {
+            const int cy = y >> 1;
+            const int oy = (y & 1) ? cs : -cs;
+            for (int x = 0; x < fine.width; ++x) {
+                const int f = y * fine.stride + x;
+                if (!fine.mask[f]) continue;
+                const int p  = cy * cs + (x >> 1);
+                const int ox = (x & 1) ? 1 : -1;
+                for (int c = 0; c < N; ++c) {
+                    const float* e = cv.u[c];
+                    fine.u[c][f] += (9.0f / 16.0f) * e[p]
+                                  + (3.0f / 16.0f) * (e[p + ox] + e[p + oy])
+                                  + (1.0f / 16.0f) * e[p + ox + oy];
+                }
+            }
+        }
+    });
+}
+
+// --- 템플릿 명시적 인스턴스화 -------------------------------------------------
+template class Multigrid<1>;
+template class Multigrid<2>;
+template class Multigrid<3>;
+template class Multigrid<4>;
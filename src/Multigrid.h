@@ -0,0 +1,89 @@
+//
+// Multigrid.h
+// WaterColorSimulation
+//
+// 암묵적 확산 시스템 (1 + 4a)u - a*이웃합(u) = b 의 기하 멀티그리드 V-사이클 풀이.
+// wetAreaMask != 0 인 셀만 미지수이고 나머지 셀은 현재 값으로 고정된 디리클레 경계.
+//
+// - 평활: 적색-흑색 가우스-자이델 (SimdKernels::diffuseRow, 행 묶음 병렬, 결과는 스레드 수와 무관)
+// - 제한: 2×2 평균 (셀 중심 격자), 조대 마스크 = 자식 중 하나라도 젖은 셀
+// - 연장: 셀 중심 쌍선형 (9/16, 3/16, 3/16, 1/16)
+// - 조대 연산자: 재이산화, 격자 간격이 2배가 되므로 a_coarse = a / 4
+//
+// a가 작은 수준은 평활만으로 빠르게 수렴하므로 거기서 조대화를 멈춘다.
+// 따라서 보통의 k*dt에서는 1수준(= 적색-흑색 평활)이고, 점성이 크거나 dt가 클 때만
+// 수준이 늘어난다. 각 수준의 비용은 이전 수준의 1/4이므로 전체 비용은 셀 수에 선형.
+//
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "PlanarField.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+// N = 성분 평면 수 (1: 스칼라, 2: 속도, 3: 색상, 4: 안료 농도 + 색상).
+// 모든 성분을 함께 반복하고 잔차는 성분 최대.
+template<int N>
+class Multigrid {
+public:
+    // field의 [x0,x1) × [y0,y1) 구간에서 풀이 (구간 밖 셀과 건조 셀은 고정값).
+    // 포인터는 셀 (0, 0), stride는 field/rhs/mask의 행 간격. 구간 주위 한 칸은 읽기 가능해야 함.
+    // 미세 격자 max 잔차가 threshold 이하가 되거나 maxCycles에 도달하면 종료.
+    // 반환: 수행한 V-사이클 수. residual에는 마지막으로 측정한 max 잔차(절댓값).
+    int solve(PlaneSet<N> field, ConstPlaneSet<N> rhs, const float* mask, int stride,
+              int x0, int y0, int x1, int y1,
+              float a, float threshold, int maxCycles,
+              const SimdKernels& kernels, ThreadPool& pool, float& residual);
+
+    // 마지막 solve에서 사용한 수준 수 (미세 격자 포함)
+    int levelCount() const { return m_levelCount; }
+
+private:
+    // 수준 하나의 접근 정보. 인덱스 = y * stride + x, 이웃은 ±1, ±stride.
+    struct View {
+        PlaneSet<N>      u;
+        ConstPlaneSet<N> b;
+        const float*     mask;
+        int              stride;
+        int              width;
+        int              height;
+        float            a;
+    };
+
+    // 조대 수준: 디리클레 0 경계를 위해 사방 1칸의 유령 셀을 둠
+    struct Level {
+        int                          width  = 0;
+        int                          height = 0;
+        float                        a      = 0.0f;
+        std::array<AlignedFloats, N> u;
+        std::array<AlignedFloats, N> b;
+        AlignedFloats                mask;
+
+        int  stride() const { return width + 2; }
+        View view() {
+            const int s = stride();
+            View v{ {}, {}, mask.data() + s + 1, s, width, height, a };
+            for (int c = 0; c < N; ++c) {
+                v.u[c] = u[c].data() + s + 1;
+                v.b[c] = b[c].data() + s + 1;
+            }
+            return v;
+        }
+    };
+
+    void  buildLevels(float a, ThreadPool& pool);
+    View  view(int level);
+    float vcycle(int level, ThreadPool& pool);
+
+    void         smooth(const View& v, int iterations, ThreadPool& pool);
+    static float residualNorm(const View& v, ThreadPool& pool);
+    static float restrictResidual(const View& fine, Level& coarse, ThreadPool& pool);
+    static void  prolongate(Level& coarse, const View& fine, ThreadPool& pool);
+
+    const SimdKernels* m_kernels = nullptr;
+    View               m_fine{};
+    std::vector<Level> m_levels;       // 조대 수준 (m_levels[0] = 두 번째 수준), 재사용
+    int                m_levelCount = 1;
+};
@@ -0,0 +1,165 @@
+//
+// PlanarField.h
+// WaterColorSimulation
+//
+// 벡터 필드의 SoA(structure-of-arrays) 저장소.
+// glm::vec2/vec3 배열(AoS) 대신 성분마다 별도의 float 평면(u/v, r/g/b)을 두어
+// 커널이 성분별로 연속 메모리를 SIMD 폭만큼 읽고 쓸 수 있게 한다.
+// 격자 필드는 메모리를 소유하지 않는 평면 뷰(FloatPlane)로, Grid가 하나의 아레나에서
+// PlaneCursor로 차례로 잘라 bind한다 (평면 시작은 64바이트 정렬).
+//
+// 셀 단위 접근은 get/set (glm 값으로 변환), 커널은 plane()/planes()로 평면 포인터를 직접 사용.
+//
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Alignment 바이트 경계에 할당하는 std::allocator 대체
+template<typename T, size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+constexpr size_t k_planeAlignment = 32;
+
+using AlignedFloats = std::vector<float, AlignedAllocator<float, k_planeAlignment>>;
+
+// 성분 N개의 평면 포인터 묶음 (N = 1이면 스칼라 필드)
+template<int N>
+using PlaneSet = std::array<float*, N>;
+
+template<int N>
+using ConstPlaneSet = std::array<const float*, N>;
+
+// 아레나를 앞에서부터 평면 단위로 잘라 주는 커서. base가 nullptr이면 크기만 센다
+// (Grid가 같은 배치 함수로 먼저 전체 크기를 재고, 할당 후 실제로 bind).
+struct PlaneCursor {
+    static constexpr size_t k_floatAlign = 16;  // 평면 시작 정렬 (64바이트 = float 16개)
+
+    float* base   = nullptr;
+    size_t offset = 0;  // float 단위
+
+    // float count개짜리 평면이 아레나에서 차지하는 길이 (다음 평면 시작까지)
+    static size_t pitch(size_t count) {
+        return (count + k_floatAlign - 1) / k_floatAlign * k_floatAlign;
+    }
+
+    float* take(size_t count) {
+        float* plane = base ? base + offset : nullptr;
+        offset += pitch(count);
+        return plane;
+    }
+};
+
+// 외부 메모리의 float 평면 하나에 대한 비소유 뷰 (스칼라 격자 필드)
+class FloatPlane {
+public:
+    static constexpr int k_planes = 1;
+
+    void bind(PlaneCursor& cursor, size_t count) {
+        m_data = cursor.take(count);
+        m_size = count;
+    }
+
+    // 이미 자른 평면에 직접 bind (ScratchPool이 교환으로 바뀐 평면을 빌려줄 때)
+    void bind(float* data, size_t count) {
+        m_data = data;
+        m_size = count;
+    }
+
+    size_t size() const { return m_size; }
+
+    float*       data()       { return m_data; }
+    const float* data() const { return m_data; }
+    float*       begin()       { return m_data; }
+    const float* begin() const { return m_data; }
+    float*       end()         { return m_data + m_size; }
+    const float* end()   const { return m_data + m_size; }
+
+    float&       operator[](size_t i)       { return m_data[i]; }
+    const float& operator[](size_t i) const { return m_data[i]; }
+
+private:
+    float* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+// 스칼라 필드를 평면 1개짜리 묶음으로
+inline PlaneSet<1> planesOf(FloatPlane& field) { return { field.data() }; }
+
+// 필드의 p번째 평면 뷰 (스칼라 필드는 자기 자신). PlanarField 정의 뒤의 오버로드 참고.
+inline FloatPlane& componentOf(FloatPlane& field, int) { return field; }
+
+template<int N>
+class PlanarField {
+public:
+    using Value = glm::vec<N, float, glm::defaultp>;
+    static constexpr int k_planes = N;
+
+    // 커서에서 성분 평면 N개를 차례로 가져옴
+    void bind(PlaneCursor& cursor, size_t count) {
+        for (FloatPlane& plane : m_planes) plane.bind(cursor, count);
+    }
+
+    size_t size() const { return m_planes[0].size(); }
+
+    // 성분 c의 평면 뷰 (ScratchPool 교환용)
+    FloatPlane& component(int c) { return m_planes[c]; }
+
+    float*       plane(int c)       { return m_planes[c].data(); }
+    const float* plane(int c) const { return m_planes[c].data(); }
+
+    PlaneSet<N> planes() {
+        PlaneSet<N> out;
+        for (int c = 0; c < N; ++c) out[c] = m_planes[c].data();
+        return out;
+    }
+    ConstPlaneSet<N> planes() const {
+        ConstPlaneSet<N> out;
+        for (int c = 0; c < N; ++c) out[c] = m_planes[c].data();
+        return out;
+    }
+
+    // --- 셀 단위 접근 (브러시, 렌더, 디버그용) ---
+
+    Value get(size_t i) const {
+        Value v;
+        for (int c = 0; c < N; ++c) v[c] = m_planes[c][i];
+        return v;
+    }
+    void set(size_t i, const Value& v) {
+        for (int c = 0; c < N; ++c) m_planes[c][i] = v[c];
+    }
+
+private:
+    std::array<FloatPlane, N> m_planes;
+};
+
+template<int N>
+FloatPlane& componentOf(PlanarField<N>& field, int c) { return field.component(c); }
+
+using Vec2Field = PlanarField<2>;
+using Vec3Field = PlanarField<3>;
@@ -0,0 +1,106 @@
+//
+// Profiler.cpp
+// WaterColorSimulation
+//
+// 링 버퍼 통계 및 CSV 저장
+//
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+const char* profileStageName(ProfileStage stage) {
+    switch (stage) {
+    case ProfileStage::DiffuseVelocity:    return "DiffuseVelocity";
+    case ProfileStage::AdvectVelocity:     return "AdvectVelocity";
+    case ProfileStage::HeightVelocity:     return "HeightVelocity";
+    case ProfileStage::BoundaryConditions: return "BoundaryConditions";
+    case ProfileStage::DiffuseWater:       return "DiffuseWater";
+    case ProfileStage::AdvectWater:        return "AdvectWater";
+    case ProfileStage::FlowOutward:        return "FlowOutward";
+    case ProfileStage::DiffusePigment:     return "DiffusePigment";
+    case ProfileStage::AdvectPigment:      return "AdvectPigment";
+    case ProfileStage::SurfaceLayer:       return "SurfaceLayer";
+    case ProfileStage::CapillaryLayer:     return "CapillaryLayer";
+    case ProfileStage::Step:               return "Step";
+    case ProfileStage::Brush:              return "Brush";
+    case ProfileStage::RenderBuffer:       return "RenderBuffer";
+    case ProfileStage::Render:             return "Render";
+    case ProfileStage::Gui:                return "Gui";
+    case ProfileStage::Frame:              return "Frame";
+    case ProfileStage::Count:              break;
+    }
+    return "?";
+}
+
+void Profiler::beginFrame() {
+    m_cursor = (m_cursor + 1) % k_historySize;
+    if (m_framesTotal < k_historySize) ++m_framesTotal;
+    for (int s = 0; s < k_stageCount; ++s) {
+        m_ms[s][m_cursor]    = 0.0f;
+        m_calls[s][m_cursor] = 0;
+    }
+}
+
+void Profiler::add(ProfileStage stage, float ms) {
+    m_ms[index(stage)][m_cursor] += ms;
+    ++m_calls[index(stage)][m_cursor];
+}
+
+Profiler::Stats Profiler::stats(ProfileStage stage) const {
+    // 정렬용 스택 버퍼 (힙 할당 없음)
+    std::array<float, k_historySize> samples;
+    int   n   = 0;
+    float sum = 0.0f;
+
+    const int s = index(stage);
+    for (int i = 0; i < k_historySize; ++i) {
+        if (m_calls[s][i] == 0) continue;
+        samples[n++] = m_ms[s][i];
+        sum += m_ms[s][i];
+    }
+
+    Stats out;
+    out.frames = n;
+    if (n == 0) return out;
+
+    out.min = *std::min_element(samples.begin(), samples.begin() + n);
+    out.avg = sum / static_cast<float>(n);
+    // p99: 상위 1% 경계 (표본이 적으면 최댓값)
+    const int k = std::min(n - 1, (n * 99) / 100);
+    std::nth_element(samples.begin(), samples.begin() + k, samples.begin() + n);
+    out.p99 = samples[k];
+    return out;
+}
+
+bool Profiler::dumpCsv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "[ERROR] Cannot write profile: " << path << "\n";
+        return false;
+    }
+
+    file << "frame";
+    for (int s = 0; s < k_stageCount; ++s)
+        file << "," << profileStageName(static_cast<ProfileStage>(s)) << "_ms";
+    file << "\n";
+
+    // 가장 오래된 프레임부터 현재 프레임까지
+    const int first = (m_cursor - m_framesTotal + 1 + k_historySize) % k_historySize;
+    for (int f = 0; f < m_framesTotal; ++f) {
+        const int slot = (first + f) % k_historySize;
+        file << f;
+        for (int s = 0; s < k_stageCount; ++s)
+            file << "," << m_ms[s][slot];
+        file << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+void Profiler::clear() {
+    for (auto& row : m_ms)    row.fill(0.0f);
+    for (auto& row : m_calls) row.fill(0);
+    m_cursor      = 0;
+    m_framesTotal = 0;
+}
@@ -0,0 +1,98 @@
+//
+// Profiler.h
+// WaterColorSimulation
+//
+// 프레임 단위 스코프 타이머. 고정 크기 링 버퍼에 단계별 소요 시간을 기록하며
+// 프레임당 힙 할당이 없다. ImGui 패널의 min/avg/p99 표시와 CSV 덤프에 사용.
+//
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+
+// 측정 단계. 시뮬레이션 서브스텝 + 메인 루프 구간.
+enum class ProfileStage : int {
+    DiffuseVelocity = 0,  // updateVelocity: diffuse(velocity)
+    AdvectVelocity,       // updateVelocity: advect(velocity)
+    HeightVelocity,       // addHeightDifferenceVelocity
+    BoundaryConditions,   // applyBoundaryConditions
+    DiffuseWater,         // updateWater: diffuse(water)
+    AdvectWater,          // updateWater: waterAdvect(water)
+    FlowOutward,          // flowOutward (가우시안 블러 포함)
+    DiffusePigment,       // updatePigment: diffuse(pigment, surfaceColor)
+    AdvectPigment,        // updatePigment: waterAdvect(pigment) + advect(surfaceColor)
+    SurfaceLayer,         // updateSurfaceLayer
+    CapillaryLayer,       // updateCapillaryLayer
+    Step,                 // Simulation::step 전체 (루프 반복당 서브스텝 합)
+    Brush,                // applyBrush
+    RenderBuffer,         // Simulation::updateRenderBuffer / updateTileLayers
+    Render,               // Renderer::render (텍스처 업로드 + 그리기)
+    Gui,                  // ImGui 프레임
+    Frame,                // 메인 루프 한 바퀴 전체
+    Count
+};
+
+const char* profileStageName(ProfileStage stage);
+
+class Profiler {
+public:
+    static constexpr int k_historySize = 240;  // 보관 프레임 수 (60Hz 기준 4초)
+    static constexpr int k_stageCount  = static_cast<int>(ProfileStage::Count);
+
+    struct Stats {
+        float min = 0.0f;  // ms
+        float avg = 0.0f;  // ms
+        float p99 = 0.0f;  // ms
+        int   frames = 0;  // 해당 단계가 실행된 프레임 수
+    };
+
+    // 새 프레임 슬롯으로 이동하고 값을 0으로 초기화
+    void beginFrame();
+
+    // 현재 프레임 슬롯에 단계 시간(ms)을 누적 (한 프레임에 여러 번 호출 가능)
+    void add(ProfileStage stage, float ms);
+
+    // 링 버퍼 전체에 대한 단계 통계 (해당 단계가 실행된 프레임만 포함)
+    Stats stats(ProfileStage stage) const;
+
+    // ImGui::PlotLines용: 단계 기록 배열과 가장 오래된 슬롯의 오프셋
+    const float* history(ProfileStage stage) const { return m_ms[index(stage)].data(); }
+    int          historyOffset() const { return (m_cursor + 1) % k_historySize; }
+
+    // 링 버퍼를 오래된 프레임부터 CSV로 저장. 실패 시 stderr 출력 후 false.
+    bool dumpCsv(const std::string& path) const;
+
+    // 기록 초기화
+    void clear();
+
+private:
+    static int index(ProfileStage stage) { return static_cast<int>(stage); }
+
+    std::array<std::array<float, k_historySize>, k_stageCount> m_ms{};     // 단계별 ms
+    std::array<std::array<int,   k_historySize>, k_stageCount> m_calls{};  // 단계별 호출 수
+    int m_cursor      = 0;  // 현재 프레임 슬롯
+    int m_framesTotal = 0;  // 기록된 프레임 수 (최대 k_historySize)
+};
+
+// 생성 시점부터 소멸 시점까지의 시간을 profiler에 기록
+class ScopedTimer {
+public:
+    ScopedTimer(Profiler& profiler, ProfileStage stage)
+        : m_profiler(profiler), m_stage(stage), m_start(Clock::now()) {}
+
+    ~ScopedTimer() {
+        const auto elapsed = Clock::now() - m_start;
+        m_profiler.add(m_stage, std::chrono::duration<float, std::milli>(elapsed).count());
+    }
+
+    ScopedTimer(const ScopedTimer&)            = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Profiler&         m_profiler;
+    ProfileStage      m_stage;
+    Clock::time_point m_start;
+};
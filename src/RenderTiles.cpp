@@ -0,0 +1,128 @@
+//
+// RenderTiles.cpp
+// WaterColorSimulation
+//
+// 화면 타일 버전 기록, 업로드 형식 변환
+//
+#include "RenderTiles.h"
+
+#include <cstring>
+
+#include "SimdKernels.h"
+
+TileLayout TileLayout::of(DisplayMode mode) {
+    TileLayout layout;
+    auto use = [&](TileLayer layer) {
+        const int l      = static_cast<int>(layer);
+        layout.used[l]   = true;
+        layout.offset[l] = layout.floats;
+        layout.floats   += k_tileArea * tileLayerChannels(layer);
+    };
+    switch (mode) {
+    case DisplayMode::Composite:
+        use(TileLayer::Paper);
+        use(TileLayer::Surface);
+        use(TileLayer::Deposit);
+        break;
+    case DisplayMode::Deposit:
+        use(TileLayer::Paper);
+        use(TileLayer::Deposit);
+        break;
+    case DisplayMode::SurfacePigment:
+        use(TileLayer::Paper);
+        use(TileLayer::Surface);
+        break;
+    default:
+        use(TileLayer::Scalar);
+        break;
+    }
+    return layout;
+}
+
+const char* tileFormatName(TileFormat format) {
+    switch (format) {
+    case TileFormat::Float32: return "float32";
+    case TileFormat::Float16: return "float16";
+    case TileFormat::Srgb8:   return "srgb8";
+    }
+    return "?";
+}
+
+size_t tileTexelBytes(TileFormat format, int channels) {
+    switch (format) {
+    case TileFormat::Float32: return channels * sizeof(float);
+    case TileFormat::Float16: return channels * sizeof(uint16_t);
+    case TileFormat::Srgb8:   return channels == 4 ? sizeof(uint32_t) : sizeof(uint16_t);
+    }
+    return 0;
+}
+
+void packTileRect(TileFormat format, const float* layer, int channels,
+                  int x0, int y0, int x1, int y1, void* out) {
+    static const SimdKernels& kernels = simdKernels(SimdLevel::Auto);
+    const int    width    = x1 - x0;
+    const size_t rowBytes = width * tileTexelBytes(format, channels);
+    auto*        dst      = static_cast<unsigned char*>(out);
+    for (int y = y0; y < y1; ++y, dst += rowBytes) {
+        const float* src = layer + channels * (static_cast<size_t>(y) * k_tileSide + x0);
+        if (format == TileFormat::Float32)
+            std::memcpy(dst, src, rowBytes);
+        else if (format == TileFormat::Srgb8 && channels == 4)
+            kernels.packSrgba8Row(src, reinterpret_cast<uint32_t*>(dst), width);
+        else
+            kernels.packHalfRow(src, reinterpret_cast<uint16_t*>(dst), width * channels);
+    }
+}
+
+void TileVersions::resize(int canvasW, int canvasH) {
+    m_canvasW = canvasW;
+    m_canvasH = canvasH;
+    for (int level = 0; level < k_tileLevels; ++level) {
+        Level&    l    = m_levels[level];
+        const int span = k_tileTexels << level;
+        l.blocksX = (canvasW + span - 1) / span * k_tileBlocks;
+        l.blocksY = (canvasH + span - 1) / span * k_tileBlocks;
+        l.versions.assign(static_cast<size_t>(l.blocksX) * l.blocksY, 0);
+    }
+}
+
+void TileVersions::markChanged(int x0, int y0, int x1, int y1, uint64_t version) {
+    x0 = std::max(0, x0);
+    y0 = std::max(0, y0);
+    if (x0 >= x1 || y0 >= y1) return;
+    for (int level = 0; level < k_tileLevels; ++level) {
+        Level&    l    = m_levels[level];
+        const int span = k_blockTexels << level;
+        int bx0 = x0 / span, bx1 = (x1 - 1) / span;
+        int by0 = y0 / span, by1 = (y1 - 1) / span;
+        // 타일 첫 블록의 셀은 왼쪽(위) 타일의 테두리 텍셀이, 마지막 블록의 셀은
+        // 오른쪽(아래) 타일의 테두리 텍셀이 샘플링 → 그 이웃 블록도 새 버전
+        if (bx0 % k_tileBlocks == 0)       --bx0;
+        if (by0 % k_tileBlocks == 0)       --by0;
+        if ((bx1 + 1) % k_tileBlocks == 0) ++bx1;
+        if ((by1 + 1) % k_tileBlocks == 0) ++by1;
+        // 캔버스 밖 텍셀은 가장자리 셀 값 → 가장자리가 바뀌면 마지막 타일의 나머지 블록도
+        if (x1 >= m_canvasW) bx1 = l.blocksX - 1;
+        if (y1 >= m_canvasH) by1 = l.blocksY - 1;
+        bx0 = std::max(bx0, 0);  bx1 = std::min(bx1, l.blocksX - 1);
+        by0 = std::max(by0, 0);  by1 = std::min(by1, l.blocksY - 1);
+        for (int by = by0; by <= by1; ++by)
+            std::fill(l.versions.begin() + static_cast<size_t>(by) * l.blocksX + bx0,
+                      l.versions.begin() + static_cast<size_t>(by) * l.blocksX + bx1 + 1, version);
+    }
+}
+
+void TileVersions::read(const TileKey& key, uint64_t floor, TileImage& out) const {
+    const Level& l = m_levels[key.level];
+    out.key     = key;
+    out.version = floor;
+    for (int by = 0; by < k_tileBlocks; ++by) {
+        const uint64_t* row = l.versions.data()
+            + static_cast<size_t>(key.y * k_tileBlocks + by) * l.blocksX + key.x * k_tileBlocks;
+        for (int bx = 0; bx < k_tileBlocks; ++bx) {
+            const uint64_t v = std::max(row[bx], floor);
+            out.blocks[by * k_tileBlocks + bx] = v;
+            out.version = std::max(out.version, v);
+        }
+    }
+}
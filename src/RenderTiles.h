@@ -0,0 +1,191 @@
+//
+// RenderTiles.h
+// WaterColorSimulation
+//
+// 화면 타일: 큰 캔버스를 화면으로 보내는 단위. 밉 수준 L의 타일 (x, y)는 2^L 셀마다
+// 한 텍셀을 샘플링한 k_tileTexels² 텍셀로 셀 사각형 (x, y) · k_tileTexels · 2^L부터를 덮는다.
+// 선형 필터링 때 타일 사이에 이음매가 없도록 이웃 셀로 채운 1텍셀 테두리를 붙여 저장.
+// 타일은 합성된 색이 아니라 표시 모드 합성(shader.frag)에 필요한 원시 필드 층(TileLayer)을
+// 싣고, 합성은 GPU가 한다.
+//
+// 타일은 k_blockTexels² 블록으로 나눠 블록마다 내용 버전을 둔다 (TileVersions).
+// 시뮬레이션 스레드는 보이는 타일에서 자기 사본보다 새 블록만 합성하고, 렌더러는
+// (타일, 밉 수준)을 키로 하는 텍스처 캐시에 캐시 사본보다 새 블록을 묶은 사각형만 올린다
+// (forEachDirtyRect). 바뀐 블록이 없으면 합성도 업로드도 없다.
+// 텍스처 하나의 크기가 타일 크기로 고정되므로 캔버스가 최대 텍스처 크기보다 커도 된다.
+// 업로드 전에 사각형을 TileFormat으로 줄일 수 있다 (packTileRect, SIMD 변환).
+//
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CanvasView.h"
+
+constexpr int    k_tileTexels = 256;                 // 타일 한 변 텍셀 수 (테두리 제외)
+constexpr int    k_tileSide   = k_tileTexels + 2;    // 저장 한 변 (양쪽 1텍셀 테두리)
+constexpr int    k_tileLevels = 8;                   // 밉 수준 0..7 (텍셀당 1..128셀)
+constexpr size_t k_tileArea   = static_cast<size_t>(k_tileSide) * k_tileSide;  // 저장 텍셀 수
+
+// 변경 추적 블록: 수준 0에서 ActiveTiles 타일(32셀)과 같은 크기
+constexpr int k_blockTexels = 32;
+constexpr int k_tileBlocks  = k_tileTexels / k_blockTexels;  // 타일 한 변의 블록 수
+
+// 화면 타일 층: 표시 모드를 GPU에서 합성하는 데 필요한 원시 필드. 층마다 텍스처 하나.
+enum class TileLayer : int {
+    Paper   = 0,  // 종이 밝기 (R). 캔버스가 바뀌지 않는 한 그대로라 타일을 처음 채울 때만
+    Surface = 1,  // 수면 안료 색 RGB (사전 곱셈) + 농도 (RGBA)
+    Deposit = 2,  // 침착 안료 색 RGB (사전 곱셈) + 농도 (RGBA)
+    Scalar  = 3,  // 스칼라 표시 모드의 필드 (R): 물, 포화도, 수평 속도, 젖은 영역, 증발
+};
+constexpr int k_tileLayerCount = 4;
+
+inline int tileLayerChannels(TileLayer layer) {
+    return layer == TileLayer::Surface || layer == TileLayer::Deposit ? 4 : 1;
+}
+
+// 표시 모드가 쓰는 층의 타일 안 배치: 쓰는 층마다 k_tileArea × 채널 수 float를 차례로
+// (층 안은 텍셀 행 우선, 채널 교차)
+struct TileLayout {
+    std::array<bool, k_tileLayerCount>   used{};
+    std::array<size_t, k_tileLayerCount> offset{};  // 층 시작 (float, 타일 시작 기준)
+    size_t                               floats = 0;  // 타일 하나의 float 수
+
+    bool has(TileLayer layer) const { return used[static_cast<int>(layer)]; }
+    size_t at(TileLayer layer) const { return offset[static_cast<int>(layer)]; }
+
+    static TileLayout of(DisplayMode mode);
+};
+
+// 텍스처 업로드 형식. 층을 CPU에서 변환해 텍셀당 바이트를 줄인다.
+enum class TileFormat : int {
+    Float32 = 0,  // 그대로 (채널당 4바이트)
+    Float16 = 1,  // half (채널당 2바이트)
+    Srgb8   = 2,  // RGBA 층은 [0, 1]로 클램프한 8비트 (RGB sRGB 인코딩, 샘플링 시 GPU가 되돌림).
+                  // 범위가 정해지지 않은 R 층은 half
+};
+
+const char* tileFormatName(TileFormat format);
+size_t      tileTexelBytes(TileFormat format, int channels);
+
+// 층(채널 channels개, 행 간격 k_tileSide 텍셀)의 저장 텍셀 사각형 [x0,x1) × [y0,y1)을 format으로
+// 변환해 out에 빈틈없이 (행 간격 = 사각형 폭) 기록. 변환은 SIMD 커널 (SimdKernels).
+void packTileRect(TileFormat format, const float* layer, int channels,
+                  int x0, int y0, int x1, int y1, void* out);
+
+// 타일의 블록별 내용 버전 (행 우선 k_tileBlocks²)
+using BlockVersions = std::array<uint64_t, k_tileBlocks * k_tileBlocks>;
+
+struct TileKey {
+    int x     = 0;
+    int y     = 0;
+    int level = 0;
+
+    bool operator==(const TileKey& o) const { return x == o.x && y == o.y && level == o.level; }
+    bool operator!=(const TileKey& o) const { return !(*this == o); }
+
+    // 해시/맵 키 (x, y < 2^28)
+    uint64_t packed() const {
+        return (static_cast<uint64_t>(level) << 56) | (static_cast<uint64_t>(y) << 28)
+             | static_cast<uint64_t>(x);
+    }
+
+    int cellsPerTexel() const { return 1 << level; }
+    int cellSpan()      const { return k_tileTexels << level; }  // 타일 한 변이 덮는 셀 수
+
+    // 덮는 셀 사각형의 왼쪽 위 (테두리 제외)
+    int cellX0() const { return x * cellSpan(); }
+    int cellY0() const { return y * cellSpan(); }
+
+    // 테두리까지 포함한 k_tileSide² 텍셀 샘플링 영역 (Simulation::updateRenderBuffer)
+    RenderRegion region() const {
+        const int s = cellsPerTexel();
+        return { cellX0() - s, cellY0() - s,
+                 cellX0() + (k_tileTexels + 1) * s, cellY0() + (k_tileTexels + 1) * s, s };
+    }
+};
+
+// 화면 타일 한 장과 그 내용 버전 (시뮬레이션 스냅샷 → 렌더러).
+// 버전은 단조 증가이므로 version(블록 최댓값)이 같으면 모든 블록이 같다.
+struct TileImage {
+    TileKey       key;
+    uint64_t      version = 0;
+    BlockVersions blocks{};
+};
+
+// now가 had보다 새 블록들을 사각형으로 묶어 저장 텍셀 좌표(테두리 포함, [0, k_tileSide))로
+// fn(x0, y0, x1, y1) 호출. 블록 행마다 연속 구간으로 묶고, 위 행과 구간이 같으면 이어 붙인다.
+// 타일 가장자리 블록은 그쪽 테두리 텍셀까지 포함.
+template<typename Fn>
+void forEachDirtyRect(const BlockVersions& now, const BlockVersions& had, Fn&& fn) {
+    struct Run { int bx0, bx1, by0, by1; };
+    std::array<Run, k_tileBlocks * k_tileBlocks> runs;
+    int count = 0;
+    for (int by = 0; by < k_tileBlocks; ++by) {
+        for (int bx = 0; bx < k_tileBlocks;) {
+            auto dirty = [&](int x) { return now[by * k_tileBlocks + x] != had[by * k_tileBlocks + x]; };
+            if (!dirty(bx)) { ++bx; continue; }
+            const int bx0 = bx;
+            while (bx < k_tileBlocks && dirty(bx)) ++bx;
+            Run* open = nullptr;
+            for (int r = 0; r < count; ++r)
+                if (runs[r].bx0 == bx0 && runs[r].bx1 == bx && runs[r].by1 == by) open = &runs[r];
+            if (open) open->by1 = by + 1;
+            else      runs[count++] = { bx0, bx, by, by + 1 };
+        }
+    }
+    auto texel = [](int block) {
+        return block == 0 ? 0 : block == k_tileBlocks ? k_tileSide : 1 + block * k_blockTexels;
+    };
+    for (int r = 0; r < count; ++r)
+        fn(texel(runs[r].bx0), texel(runs[r].by0), texel(runs[r].bx1), texel(runs[r].by1));
+}
+
+// 픽셀당 셀 수에 맞는 밉 수준: 텍셀이 화면 픽셀보다 작아지지 않는 가장 세밀한 수준
+inline int tileLevel(float cellsPerPixel) {
+    const int level = cellsPerPixel > 1.0f ? static_cast<int>(std::floor(std::log2(cellsPerPixel))) : 0;
+    return std::min(level, k_tileLevels - 1);
+}
+
+// view에 보이는 level 수준 타일마다 fn(TileKey) 호출 (행 우선, 캔버스 밖 타일 제외)
+template<typename Fn>
+void forEachVisibleTile(const CanvasView& view, int canvasW, int canvasH, int level, Fn&& fn) {
+    const glm::vec2 end  = view.origin + glm::vec2(view.viewport) * view.cellsPerPixel;
+    const float     span = static_cast<float>(k_tileTexels << level);
+    const int tx0 = static_cast<int>(std::max(0.0f, view.origin.x) / span);
+    const int ty0 = static_cast<int>(std::max(0.0f, view.origin.y) / span);
+    const int tx1 = static_cast<int>(std::ceil(std::min(static_cast<float>(canvasW), end.x) / span));
+    const int ty1 = static_cast<int>(std::ceil(std::min(static_cast<float>(canvasH), end.y) / span));
+    for (int ty = ty0; ty < ty1; ++ty)
+        for (int tx = tx0; tx < tx1; ++tx)
+            fn(TileKey{ tx, ty, level });
+}
+
+// 밉 수준별 화면 타일 블록의 내용 버전. 셀 사각형이 바뀌면 그 셀을 (이웃 타일의 테두리
+// 텍셀까지 포함해) 샘플링하는 모든 수준의 블록에 새 버전을 기록한다.
+// 버전은 호출자가 단조 증가로 매김.
+class TileVersions {
+public:
+    // 캔버스 크기에 맞게 수준별 배열을 만들고 모두 0으로
+    void resize(int canvasW, int canvasH);
+
+    // 셀 사각형 [x0,x1) × [y0,y1)을 샘플링하는 블록을 version으로
+    void markChanged(int x0, int y0, int x1, int y1, uint64_t version);
+
+    // key 타일의 블록 버전 (floor보다 오래된 블록은 floor, 예: 표시 모드 변경 시점)과 그 최댓값
+    void read(const TileKey& key, uint64_t floor, TileImage& out) const;
+
+private:
+    struct Level {
+        int                   blocksX = 0;  // 타일 수 × k_tileBlocks (캔버스 밖 블록 포함)
+        int                   blocksY = 0;
+        std::vector<uint64_t> versions;
+    };
+    std::array<Level, k_tileLevels> m_levels;
+    int                             m_canvasW = 0;
+    int                             m_canvasH = 0;
+};
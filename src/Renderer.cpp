@@ -2,11 +2,12 @@
 // Renderer.cpp
 // WaterColorSimulation
 //
-// OpenGL texture management and full-screen quad rendering.
+// OpenGL tile texture cache and per-tile quad rendering.
 //
 #include "Renderer.h"
 #include "ShaderUtils.h"
 
+#include <algorithm>
 #include <iostream>
 #include <glm/glm.hpp>
 
@@ -17,34 +18,31 @@ SimulationTexture::~SimulationTexture() {
         glDeleteTextures(1, &m_texHandle);
 }
 
-void SimulationTexture::upload(int width, int height,
-                                GLuint format, GLuint type,
-                                const void* data) {
-    // Recreate the texture object if dimensions or format changed
-    if (width != m_width || height != m_height || format != m_format || type != m_type) {
-        if (m_texHandle > 0) glDeleteTextures(1, &m_texHandle);
-        m_texHandle = 0;
-    }
+void SimulationTexture::allocate(int width, int height, GLuint internalFormat,
+                                 GLuint format, GLuint type) {
+    if (m_texHandle > 0 && width == m_width && height == m_height && internalFormat == m_internalFormat)
+        return;
+    if (m_texHandle > 0) glDeleteTextures(1, &m_texHandle);
 
-    m_width  = width;
-    m_height = height;
-    m_format = format;
-    m_type   = type;
-
-    if (m_texHandle == 0) {
-        // First upload: create and configure a new texture object
-        glGenTextures(1, &m_texHandle);
-        glBindTexture(GL_TEXTURE_2D, m_texHandle);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, format, type, data);
-    } else {
-        // Subsequent uploads: just replace the pixel data (faster path)
-        glBindTexture(GL_TEXTURE_2D, m_texHandle);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, data);
-    }
+    m_width          = width;
+    m_height         = height;
+    m_internalFormat = internalFormat;
+
+    glGenTextures(1, &m_texHandle);
+    glBindTexture(GL_TEXTURE_2D, m_texHandle);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // glTexStorage2D needs GL 4.2; the 4.1 context allocates through glTexImage2D
+    glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), width, height, 0,
+                 format, type, nullptr);
+}
+
+void SimulationTexture::uploadRect(int x, int y, int width, int height,
+                                   GLuint format, GLuint type, const void* data) {
+    glBindTexture(GL_TEXTURE_2D, m_texHandle);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, type, data);
 }
 
 void SimulationTexture::bind(GLuint program,
@@ -57,7 +55,37 @@ void SimulationTexture::bind(GLuint program,
 
 // --- Renderer -----------------------------------------------------------------
 
+namespace {
+
+struct GlFormat {
+    GLuint internalFormat;
+    GLuint format;
+    GLuint type;
+};
+
+// Sampler uniform of each TileLayer in shader.frag (texture unit = layer index)
+const char* const k_layerSamplers[k_tileLayerCount] = {
+    "paperTex", "surfaceTex", "depositTex", "scalarTex"
+};
+
+// Texture formats of a layer with channels (1 or 4) packed as format (packTileRect)
+GlFormat glFormatOf(TileFormat format, int channels) {
+    if (format == TileFormat::Float32)
+        return channels == 4 ? GlFormat{ GL_RGBA32F, GL_RGBA, GL_FLOAT }
+                             : GlFormat{ GL_R32F, GL_RED, GL_FLOAT };
+    if (format == TileFormat::Srgb8 && channels == 4)
+        return { GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE };
+    return channels == 4 ? GlFormat{ GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT }
+                         : GlFormat{ GL_R16F, GL_RED, GL_HALF_FLOAT };
+}
+
+} // anonymous namespace
+
 Renderer::~Renderer() {
+    for (UploadBuffer& buffer : m_ring) {
+        if (buffer.fence) glDeleteSync(buffer.fence);
+        if (buffer.pbo)   glDeleteBuffers(1, &buffer.pbo);
+    }
     if (m_program)    glDeleteProgram(m_program);
     if (m_vertShader) glDeleteShader(m_vertShader);
     if (m_fragShader) glDeleteShader(m_fragShader);
@@ -71,20 +99,178 @@ void Renderer::init(const std::string& vertShaderPath,
     m_fragShader = frag;
 }
 
-void Renderer::render(const float* data, int width, int height) {
+void Renderer::render(const std::vector<TileImage>& tiles, const float* layers, DisplayMode mode,
+                      const CanvasView& view, int canvasW, int canvasH) {
     if (m_program == 0) {
         std::cerr << "[Renderer] Shaders not loaded. Call init() first.\n";
         return;
     }
+    ++m_frame;
+    m_uploaded      = 0;
+    m_uploadedBytes = 0;
+
+    // Collect changed tiles (the snapshot holds only tiles visible when it was made):
+    // a cached tile of the same mode gets just its newer blocks, a new or re-keyed
+    // slot or a mode change every layer of the whole tile
+    const TileLayout layout = TileLayout::of(mode);
+    m_pending.clear();
+    for (size_t i = 0; i < tiles.size() && m_uploaded < k_maxUploadsPerFrame; ++i) {
+        const TileImage& image = tiles[i];
+        const auto       found = m_tiles.find(image.key.packed());
+        if (found != m_tiles.end() && found->second.version == image.version) continue;
+        CachedTile* tile = found != m_tiles.end() ? &found->second : slotFor(image.key);
+        if (!tile) break;
+        const bool whole = found == m_tiles.end() || tile->mode != mode;
 
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        const float* source = layers + i * layout.floats;
+        for (int l = 0; l < k_tileLayerCount; ++l) {
+            const TileLayer layer = static_cast<TileLayer>(l);
+            if (!layout.has(layer) || (!whole && layer == TileLayer::Paper)) continue;
+            const int          channels = tileLayerChannels(layer);
+            const size_t       bytes    = tileTexelBytes(m_format, channels);
+            SimulationTexture& texture  = tile->layers[l];
+            auto queue = [&](int x0, int y0, int x1, int y1) {
+                m_pending.push_back({ &texture, source + layout.at(layer), channels,
+                                      x0, y0, x1, y1, m_uploadedBytes });
+                m_uploadedBytes += static_cast<size_t>(x1 - x0) * (y1 - y0) * bytes;
+            };
+            if (whole) {
+                const GlFormat gl = glFormatOf(m_format, channels);
+                texture.allocate(k_tileSide, k_tileSide, gl.internalFormat, gl.format, gl.type);
+                queue(0, 0, k_tileSide, k_tileSide);
+            } else {
+                forEachDirtyRect(image.blocks, tile->blocks, queue);
+            }
+        }
+        tile->mode     = mode;
+        tile->version  = image.version;
+        tile->blocks   = image.blocks;
+        tile->lastUsed = m_frame;
+        ++m_uploaded;
+    }
+    if (!m_pending.empty()) flushUploads();
+
+    glClearColor(0.12f, 0.12f, 0.12f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     glUseProgram(m_program);
+    setUniform(m_program, "view",
+               glm::vec4(view.origin, glm::vec2(view.viewport) * view.cellsPerPixel));
+
+    // Draw every visible tile of the current view (it may be newer than the snapshot's)
+    const int level = tileLevel(view.cellsPerPixel);
+    forEachVisibleTile(view, canvasW, canvasH, level, [&](const TileKey& key) {
+        const int x0 = key.cellX0(), x1 = std::min(x0 + key.cellSpan(), canvasW);
+        const int y0 = key.cellY0(), y1 = std::min(y0 + key.cellSpan(), canvasH);
+        // Exact tile first, then ever coarser ancestors while it is being streamed
+        for (int up = 0; key.level + up < k_tileLevels; ++up) {
+            const TileKey texKey{ key.x >> up, key.y >> up, key.level + up };
+            const auto    found = m_tiles.find(texKey.packed());
+            if (found == m_tiles.end()) continue;
+            found->second.lastUsed = m_frame;
+            drawTile(found->second, texKey, x0, y0, x1, y1);
+            break;
+        }
+    });
+}
+
+void Renderer::clearTiles() {
+    m_tiles.clear();
+}
+
+void Renderer::setTileFormat(TileFormat format) {
+    if (format == m_format) return;
+    m_format = format;
+    clearTiles();
+}
+
+void Renderer::flushUploads() {
+    UploadBuffer& buffer = m_ring[m_ringIndex];
+    m_ringIndex = (m_ringIndex + 1) % k_uploadRing;
+
+    // The copies last queued from this buffer were issued k_uploadRing frames
+    // ago; waiting on their fence normally returns at once
+    bool idle = true;
+    if (buffer.fence) {
+        const GLenum wait = glClientWaitSync(buffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        idle = wait == GL_ALREADY_SIGNALED || wait == GL_CONDITION_SATISFIED;
+        glDeleteSync(buffer.fence);
+        buffer.fence = nullptr;
+    }
+
+    if (!buffer.pbo) glGenBuffers(1, &buffer.pbo);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+    if (buffer.bytes < m_uploadedBytes) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(m_uploadedBytes), nullptr,
+                     GL_STREAM_DRAW);
+        buffer.bytes = m_uploadedBytes;
+    }
+
+    // Once its fence has signalled the driver need not synchronise the mapping
+    const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+                            | (idle ? GL_MAP_UNSYNCHRONIZED_BIT : 0);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0,
+                                    static_cast<GLsizeiptr>(m_uploadedBytes), access);
+    if (!mapped) {
+        std::cerr << "[ERROR] Failed to map the tile upload buffer\n";
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        clearTiles();  // contents unknown: upload every tile again
+        return;
+    }
+    for (const PendingUpload& up : m_pending)
+        packTileRect(m_format, up.layer, up.channels, up.x0, up.y0, up.x1, up.y1,
+                     static_cast<unsigned char*>(mapped) + up.offset);
+    if (!glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+        std::cerr << "[ERROR] Tile upload buffer was lost while mapped\n";
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        clearTiles();
+        return;
+    }
+
+    // Copies are queued from the buffer; the CPU does not wait for them.
+    // Half-float R rows of odd width are not 4-byte multiples.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (const PendingUpload& up : m_pending) {
+        const GlFormat gl = glFormatOf(m_format, up.channels);
+        up.texture->uploadRect(up.x0, up.y0, up.x1 - up.x0, up.y1 - up.y0, gl.format, gl.type,
+                               reinterpret_cast<const void*>(up.offset));
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+Renderer::CachedTile* Renderer::slotFor(const TileKey& key) {
+    const uint64_t packed = key.packed();
+    const auto     found  = m_tiles.find(packed);
+    if (found != m_tiles.end()) return &found->second;
+    if (static_cast<int>(m_tiles.size()) < k_maxCachedTiles) return &m_tiles[packed];
+
+    // Full: re-key the least recently used tile, keeping its texture object
+    auto victim = m_tiles.end();
+    for (auto it = m_tiles.begin(); it != m_tiles.end(); ++it)
+        if (victim == m_tiles.end() || it->second.lastUsed < victim->second.lastUsed) victim = it;
+    if (victim->second.lastUsed == m_frame) return nullptr;
+
+    auto node  = m_tiles.extract(victim);
+    node.key() = packed;
+    return &m_tiles.insert(std::move(node)).position->second;
+}
 
-    // Upload the current simulation frame to the GPU texture
-    m_texture.upload(width, height, GL_RGB, GL_FLOAT, data);
-    m_texture.bind(m_program, "tex", 0);
+void Renderer::drawTile(const CachedTile& tile, const TileKey& texKey,
+                        int x0, int y0, int x1, int y1) {
+    // Cell position p maps to texel (p - tile origin) / cellsPerTexel, offset by the border texel
+    const float s  = static_cast<float>(texKey.cellsPerTexel());
+    const float ox = static_cast<float>(texKey.cellX0());
+    const float oy = static_cast<float>(texKey.cellY0());
+    auto texU = [&](int p, float o) { return (1.0f + (static_cast<float>(p) - o) / s) / k_tileSide; };
 
+    const TileLayout layout = TileLayout::of(tile.mode);
+    for (int l = 0; l < k_tileLayerCount; ++l)
+        if (layout.used[l]) tile.layers[l].bind(m_program, k_layerSamplers[l], l);
+    setUniform(m_program, "mode",    static_cast<int>(tile.mode));
+    setUniform(m_program, "quad",    glm::vec4(x0, y0, x1 - x0, y1 - y0));
+    setUniform(m_program, "texRect", glm::vec4(texU(x0, ox), texU(y0, oy),
+                                               texU(x1, ox), texU(y1, oy)));
     drawFullscreenQuad();
 }
@@ -3,27 +3,50 @@
 // WaterColorSimulation
 //
 // OpenGL renderer for the watercolor simulation output.
-// Manages a float RGB texture that is updated each frame and displayed
-// via a full-screen quad shader.
+// The canvas reaches the GPU as fixed-size screen tiles (RenderTiles.h) kept in
+// a texture cache keyed by tile and mip level. A tile holds the raw field layers
+// of its display mode, one texture each, and shader.frag composites the mode.
+// The paper layer is uploaded only when a tile is first filled. Each frame only the blocks of a
+// tile newer than the cached copy are uploaded, as sub-rectangles of its
+// texture (forEachDirtyRect); every visible tile is then drawn as a quad
+// placed by the current pan/zoom view, so canvases larger than the maximum
+// texture size work and upload cost follows what changed on screen.
+// Uploads are packed to the selected TileFormat straight into a ring of pixel
+// buffer objects, so glTexSubImage2D only queues a GPU-side copy and a buffer
+// is not rewritten until the fence of its last use has signalled.
 //
 // Originally derived from TexView.hpp (Hyun Joon Shin, 2021) and the
 // Tex helper struct, adapted for standalone GLFW/GLEW usage.
 //
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <GL/glew.h>
+#include <glm/glm.hpp>
 
-// Wraps a single OpenGL 2D texture that can be efficiently updated
-// from a CPU-side float RGB buffer.
+#include "CanvasView.h"
+#include "RenderTiles.h"
+
+// Wraps a single OpenGL 2D texture that is updated in sub-rectangles.
 class SimulationTexture {
 public:
     SimulationTexture() = default;
     ~SimulationTexture();
 
-    // Creates or resizes the texture, then uploads pixel data.
-    // format: e.g. GL_RGB   type: e.g. GL_FLOAT
-    void upload(int width, int height, GLuint format, GLuint type, const void* data);
+    // Creates the texture storage, or recreates it if the size or internal
+    // format changed (contents are then undefined until uploaded).
+    // internalFormat: e.g. GL_SRGB8_ALPHA8, with a matching format/type pair
+    void allocate(int width, int height, GLuint internalFormat, GLuint format, GLuint type);
+
+    // Replaces the sub-rectangle [x, x + width) x [y, y + height) with tightly
+    // packed rows. data is an offset when a pixel unpack buffer is bound.
+    // format: e.g. GL_RGBA   type: e.g. GL_UNSIGNED_BYTE
+    void uploadRect(int x, int y, int width, int height,
+                    GLuint format, GLuint type, const void* data);
 
     // Binds the texture to the given texture unit and sets the sampler uniform.
     void bind(GLuint program, const std::string& uniformName, int unit = 0) const;
@@ -31,31 +54,97 @@ public:
     GLuint handle() const { return m_texHandle; }
 
 private:
-    GLuint m_texHandle = 0;
-    int    m_width     = 0;
-    int    m_height    = 0;
-    GLuint m_format    = GL_RGB;
-    GLuint m_type      = GL_UNSIGNED_BYTE;
+    GLuint m_texHandle      = 0;
+    int    m_width          = 0;
+    int    m_height         = 0;
+    GLuint m_internalFormat = GL_RGB;
 };
 
-// Loads the watercolor output shaders and renders the simulation texture
-// as a full-screen quad each frame.
+// Loads the watercolor output shaders and draws the cached screen tiles
+// visible in the current view each frame.
 class Renderer {
 public:
+    // Cache capacity (tiles of k_tileSide^2 texels) and per-frame upload cap.
+    // Tiles over the cap keep their old version and are retried next frame.
+    static constexpr int k_maxCachedTiles     = 128;
+    static constexpr int k_maxUploadsPerFrame = 16;
+
     Renderer() = default;
     ~Renderer();
 
     // Loads shaders from the given file paths. Must be called once after
     // an OpenGL context exists.
     void init(const std::string& vertShaderPath, const std::string& fragShaderPath);
+    bool loaded() const { return m_program != 0; }
+
+    // Uploads the blocks of each tile newer than the cached copy, then draws
+    // the tiles visible in view at its mip level. A tile not cached yet is drawn
+    // from a cached coarser level if there is one, otherwise left as background.
+    // tiles:  screen tiles with content versions
+    // layers: TileLayout::of(mode).floats floats per tile, in tiles order
+    // mode:   display mode the layers were filled for
+    void render(const std::vector<TileImage>& tiles, const float* layers, DisplayMode mode,
+                const CanvasView& view, int canvasW, int canvasH);
+
+    // Drops every cached tile (the canvas was replaced, versions start over).
+    void clearTiles();
+
+    // Texture format tiles are packed to before upload. Changing it drops the cache.
+    void       setTileFormat(TileFormat format);
+    TileFormat tileFormat() const { return m_format; }
 
-    // Uploads new pixel data and redraws the full-screen quad.
-    // data: pointer to width*height*3 floats (RGB, row-major)
-    void render(const float* data, int width, int height);
+    int    uploadedTiles() const { return m_uploaded; }       // during the last render
+    size_t uploadedBytes() const { return m_uploadedBytes; }  // during the last render
+    int cachedTiles()   const { return static_cast<int>(m_tiles.size()); }
 
 private:
+    struct CachedTile {
+        std::array<SimulationTexture, k_tileLayerCount> layers;  // by TileLayer
+        DisplayMode   mode     = DisplayMode::Composite;  // mode the layers hold
+        uint64_t      version  = 0;
+        BlockVersions blocks{};      // per-block versions of the uploaded content
+        uint64_t      lastUsed = 0;  // frame number (LRU eviction)
+    };
+
+    // Cache slot for key: existing, new, or the least recently used one re-keyed.
+    // nullptr if the cache is full of tiles used this frame.
+    CachedTile* slotFor(const TileKey& key);
+
+    // One pending sub-rectangle upload of a frame, packed at offset in the ring buffer.
+    struct PendingUpload {
+        SimulationTexture* texture;
+        const float*       layer;  // the snapshot's layer of the tile
+        int                channels;
+        int                x0, y0, x1, y1;
+        size_t             offset;
+    };
+
+    // Packs the pending uploads into the next ring buffer and queues the copies
+    // into the tile textures.
+    void flushUploads();
+
+    // Draws the canvas rectangle [x0, x1) x [y0, y1) from the layers of tile texKey.
+    void drawTile(const CachedTile& tile, const TileKey& texKey,
+                  int x0, int y0, int x1, int y1);
+
     GLuint           m_program  = 0;
     GLuint           m_vertShader = 0;
     GLuint           m_fragShader = 0;
-    SimulationTexture m_texture;
+    std::unordered_map<uint64_t, CachedTile> m_tiles;  // TileKey::packed() -> tile
+    uint64_t         m_frame    = 0;
+    int              m_uploaded = 0;
+    size_t           m_uploadedBytes = 0;
+
+    // Pixel unpack buffer ring: each frame's uploads use the next buffer, whose
+    // previous copies are fenced. Grown to the largest frame's uploads.
+    static constexpr int k_uploadRing = 3;
+    struct UploadBuffer {
+        GLuint pbo   = 0;
+        GLsync fence = nullptr;
+        size_t bytes = 0;
+    };
+    std::array<UploadBuffer, k_uploadRing> m_ring;
+    int                        m_ringIndex = 0;
+    std::vector<PendingUpload> m_pending;
+    TileFormat                 m_format    = TileFormat::Float16;
 };
@@ -0,0 +1,108 @@
+//
+// ScratchPool.h
+// WaterColorSimulation
+//
+// 서브스텝 안에서만 쓰는 격자 크기 임시 평면의 풀 (Simulation 소유).
+// 이전 값 전체를 읽는 커널(이류, 확산 우변, 모세관 확산, 블러)의 출력/작업 공간을 필드마다
+// 상주 버퍼로 두지 않고, Grid::scratch 구역의 평면을 스택처럼 빌려주고 돌려받는다.
+// 구역 크기는 동시에 빌리는 최대 평면 수 (Grid::k_scratchPlanes).
+//
+// 사용: Scratch<Vec3Field> tmp(pool);  → tmp->planes() ... 범위를 벗어나면 반납.
+// 빌린 평면의 내용은 이전 사용자의 값 (초기화하지 않음).
+//
+// 커널 출력을 필드로 옮길 때는 복사 대신 swapInto로 평면을 맞바꿀 수 있다: 필드는 출력 평면을,
+// 풀의 슬롯은 필드의 이전 평면을 갖는다. 그래서 상태 필드 평면이 scratch 구역에, scratch 슬롯이
+// 상태 구역에 있을 수 있다 (Grid::reset은 두 구역을 함께 초기화).
+//
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "PlanarField.h"
+
+class ScratchPool {
+public:
+    // region: 평면 capacity개를 담는 구역 (bind 전이어도 됨, 빌릴 때 주소를 읽음),
+    // planeSize: 평면 하나의 float 수
+    ScratchPool(FloatPlane& region, size_t planeSize, int capacity)
+        : m_region(region), m_planeSize(planeSize), m_capacity(capacity) {}
+
+    ScratchPool(const ScratchPool&)            = delete;
+    ScratchPool& operator=(const ScratchPool&) = delete;
+
+    size_t planeSize() const { return m_planeSize; }
+    int    capacity()  const { return m_capacity; }
+
+    // 지금까지 동시에 빌린 최대 평면 수 (메모리 보고용)
+    int peak() const { return m_peak; }
+
+private:
+    template<typename T>
+    friend class Scratch;
+
+    // 평면 count개를 빌려 첫 슬롯 번호를 돌려줌. 용량 초과는 구역 크기 설정 오류이므로 중단.
+    int acquire(int count) {
+        if (m_used + count > m_capacity) {
+            std::cerr << "[ERROR] Scratch pool exhausted (" << m_used + count
+                      << " planes requested, capacity " << m_capacity << ")\n";
+            std::abort();
+        }
+        if (m_slots.empty()) {
+            // 처음 빌릴 때 구역을 슬롯으로 자름 (구역은 Grid::init에서 bind되므로 생성 시점엔 없음)
+            PlaneCursor cursor{ m_region.data() };
+            for (int i = 0; i < m_capacity; ++i) m_slots.push_back(cursor.take(m_planeSize));
+        }
+        const int first = m_used;
+        m_used += count;
+        m_peak  = std::max(m_peak, m_used);
+        return first;
+    }
+
+    // used개만 남기고 반납 (빌린 역순)
+    void release(int used) { m_used = used; }
+
+    FloatPlane&         m_region;
+    size_t              m_planeSize;
+    int                 m_capacity;
+    int                 m_used = 0;
+    int                 m_peak = 0;
+    std::vector<float*> m_slots;  // 슬롯별 현재 평면 (swapInto로 바뀜)
+};
+
+// 풀에서 T(FloatPlane 또는 PlanarField<N>)의 평면을 빌려 수명 동안 보유
+template<typename T>
+class Scratch {
+public:
+    explicit Scratch(ScratchPool& pool) : m_pool(pool), m_mark(pool.acquire(T::k_planes)) {
+        for (int p = 0; p < T::k_planes; ++p)
+            componentOf(m_value, p).bind(pool.m_slots[m_mark + p], pool.planeSize());
+    }
+    ~Scratch() { m_pool.release(m_mark); }
+
+    // 빌린 평면과 field의 평면을 맞바꿈: field는 지금까지 쓴 내용을, 이 Scratch(와 반납 후의
+    // 풀 슬롯)는 field의 이전 평면을 갖는다. 평면 크기는 같아야 함 (Grid::cellCount()).
+    void swapInto(T& field) {
+        for (int p = 0; p < T::k_planes; ++p) {
+            FloatPlane& mine = componentOf(m_value, p);
+            std::swap(mine, componentOf(field, p));
+            m_pool.m_slots[m_mark + p] = mine.data();
+        }
+    }
+
+    Scratch(const Scratch&)            = delete;
+    Scratch& operator=(const Scratch&) = delete;
+
+    T&       operator*()        { return m_value; }
+    const T& operator*()  const { return m_value; }
+    T*       operator->()       { return &m_value; }
+    const T* operator->() const { return &m_value; }
+
+private:
+    ScratchPool& m_pool;
+    int          m_mark;
+    T            m_value;
+};
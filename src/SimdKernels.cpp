@@ -0,0 +1,333 @@
+//
+// SimdKernels.cpp
+// WaterColorSimulation
+//
+// 스칼라 기준 커널 + sRGB 인코딩 표 + CPUID 기반 구현 선택
+//
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace {
+
+float diffuseRowScalar(float* const* u, const float* const* b, int planes, const float* mask,
+                       int stride, int x0, int x1, int parity, float a, float diag) {
+    float change = 0.0f;
+    for (int x = x0 + ((x0 + parity) & 1); x < x1; x += 2) {
+        if (!mask[x]) continue;
+        for (int p = 0; p < planes; ++p) {
+            float*      f       = u[p];
+            const float updated = (b[p][x] + a * (f[x - 1] + f[x + 1]
+                                                  + f[x - stride] + f[x + stride])) / diag;
+            change = std::max(change, std::abs(updated - f[x]));
+            f[x]   = updated;
+        }
+    }
+    return change;
+}
+
+void advectRowScalar(const AdvectArgs& args, int y, int x0, int x1) {
+    const int   s  = args.stride;
+    const float wx = static_cast<float>(args.width  - 1) - 1e-6f;
+    const float wy = static_cast<float>(args.height - 1) - 1e-6f;
+
+    for (int x = x0; x < x1; ++x) {
+        const std::ptrdiff_t c = static_cast<std::ptrdiff_t>(y) * s + x;
+        // 출발점을 [0, w-1] × [0, h-1]로 클램프 (glm::max(0, glm::min(w, p))와 동일)
+        float px = static_cast<float>(x) - args.dt * args.velU[c];
+        float py = static_cast<float>(y) - args.dt * args.velV[c];
+        px = px < wx ? px : wx;   px = 0.0f < px ? px : 0.0f;
+        py = py < wy ? py : wy;   py = 0.0f < py ? py : 0.0f;
+
+        // ix == width-1이면 sx == 0이고 +1 이웃은 가장자리 값을 복제한 유령 셀
+        const int            ix  = static_cast<int>(std::floor(px));
+        const int            iy  = static_cast<int>(std::floor(py));
+        const float          sx  = px - static_cast<float>(ix);
+        const float          t   = py - static_cast<float>(iy);
+        const std::ptrdiff_t i00 = static_cast<std::ptrdiff_t>(iy) * s + ix;
+
+        for (int p = 0; p < args.planes; ++p) {
+            const float* f  = args.src[p] + i00;
+            const float  v0 = f[0] * (1.0f - sx) + f[1]     * sx;
+            const float  v1 = f[s] * (1.0f - sx) + f[s + 1] * sx;
+            args.dst[p][c]  = v0 * (1.0f - t) + v1 * t;
+        }
+    }
+}
+
+void surfaceLayerRowScalar(const SurfaceLayerArgs& args, int y, int x0, int x1) {
+    for (int c = y * args.stride + x0; c < y * args.stride + x1; ++c) {
+        if (!args.wetAreaMask[c]) continue;
+        const float pigment = args.pigment[c];
+        const float deposit = args.deposit[c];
+        const float height  = args.heightMap[c];
+
+        // 경계 강화 인자 (edge darkening, Van Laerhoven §3.3):
+        // 경계(evaporation≈0)에서 흡착이 강해져 특유의 어두운 테두리 생성
+        const float boundaryFactor = 1.0f + std::max(0.0f, 1.0f - args.evaporation[c]) * 3.0f;
+
+        // 흡착: 종이 골(높이 낮음)에 더 많이 침착
+        float adsorb = pigment * (1.0f - height * args.granulation)
+                       * args.density * boundaryFactor;
+
+        // 탈착: 종이 봉우리(높이 높음)에서 재용출, 착색력으로 억제
+        float desorb = deposit * (1.0f - (1.0f - height) * args.granulation)
+                       * args.density / args.staining;
+
+        // 각 레이어가 1.0을 초과하지 않도록 클램프
+        if (deposit + adsorb > 1.0f) adsorb = std::max(0.0f, 1.0f - deposit);
+        if (pigment + desorb > 1.0f) desorb = std::max(0.0f, 1.0f - pigment);
+
+        // 사전 곱셈 색상 이전: 농도 비율만큼 색상도 비례 이동
+        if (adsorb > 0.0f && pigment > 0.001f) {
+            const float ratio = adsorb / pigment;
+            for (int p = 0; p < 3; ++p) {
+                const float transfer = args.surfaceColor[p][c] * ratio;
+                args.depositColor[p][c] += transfer;
+                args.surfaceColor[p][c] -= transfer;
+            }
+        }
+        if (desorb > 0.0f && deposit > 0.001f) {
+            const float ratio = desorb / deposit;
+            for (int p = 0; p < 3; ++p) {
+                const float transfer = args.depositColor[p][c] * ratio;
+                args.surfaceColor[p][c] += transfer;
+                args.depositColor[p][c] -= transfer;
+            }
+        }
+
+        args.deposit[c] = deposit + (adsorb - desorb);
+        args.pigment[c] = pigment + (desorb - adsorb);
+    }
+}
+
+void waterFluxRowScalar(const WaterFluxArgs& args, int y, int x0, int x1) {
+    const int    s          = args.stride;
+    const float* field      = args.field;
+    float*       out        = args.out;
+    const float* mask       = args.mask;
+    const float* velU       = args.velU;
+    const float* velV       = args.velV;
+    const float  dt         = args.dt;
+    const float  maxValue   = args.maxValue;
+    const float  minValue   = args.minValue;
+
+    const std::ptrdiff_t row = static_cast<std::ptrdiff_t>(y) * s;
+    for (std::ptrdiff_t c = row + x0; c < row + x1; ++c) {
+        const std::ptrdiff_t xp = c + 1;
+        const std::ptrdiff_t xm = c - 1;
+        const std::ptrdiff_t yp = c + s;
+        const std::ptrdiff_t ym = c - s;
+
+        // 면 중심 속도: 인접 셀 평균, 건조 경계는 0으로 차단
+        float vx1 = mask[c] * mask[xp] * (velU[c] + velU[xp]) * 0.5f;
+        float vx2 = mask[c] * mask[xm] * (velU[c] + velU[xm]) * 0.5f;
+        float vy1 = mask[c] * mask[yp] * (velV[c] + velV[yp]) * 0.5f;
+        float vy2 = mask[c] * mask[ym] * (velV[c] + velV[ym]) * 0.5f;
+
+        float flux = 0.0f;
+        float t    = field[c];
+
+        // +x 면
+        if (vx1 > 0.0f) {
+            flux = vx1 * dt * field[c] / 4.0f;
+            t -= std::min(std::abs(maxValue - field[xp]),
+                          std::min(std::abs(flux), std::abs(minValue - field[c])));
+        } else {
+            flux = vx1 * dt * field[xp] / 4.0f;
+            t += std::min(std::abs(maxValue - field[c]),
+                          std::min(std::abs(flux), std::abs(minValue - field[xm])));
+        }
+
+        // -x 면
+        if (vx2 > 0.0f) {
+            flux = vx2 * dt * field[xm] / 4.0f;
+            t += std::min(std::abs(maxValue - field[c]),
+                          std::min(std::abs(flux), std::abs(minValue - field[xm])));
+        } else {
+            flux = vx2 * dt * field[c] / 4.0f;
+            t -= std::min(std::abs(maxValue - field[xm]),
+                          std::min(std::abs(flux), std::abs(minValue - field[c])));
+        }
+
+        // +y 면
+        if (vy1 > 0.0f) {
+            flux = vy1 * dt * field[c] / 4.0f;
+            t -= std::min(std::abs(maxValue - field[c]),
+                          std::min(std::abs(flux), std::abs(minValue - field[ym])));
+        } else {
+            flux = vy1 * dt * field[yp] / 4.0f;
+            t += std::min(std::abs(maxValue - field[ym]),
+                          std::min(std::abs(flux), std::abs(minValue - field[c])));
+        }
+
+        // -y 면
+        if (vy2 > 0.0f) {
+            flux = vy2 * dt * field[ym] / 4.0f;
+            t += std::min(std::abs(maxValue - field[yp]),
+                          std::min(std::abs(flux), std::abs(minValue - field[c])));
+        } else {
+            flux = vy2 * dt * field[c] / 4.0f;
+            t -= std::min(std::abs(maxValue - field[c]),
+                          std::min(std::abs(flux), std::abs(minValue - field[yp])));
+        }
+
+        out[c] = t;
+    }
+}
+
+void compositeRowScalar(const CompositeArgs& args, int y, int x0, int x1, float* rgb) {
+    const std::ptrdiff_t row = static_cast<std::ptrdiff_t>(y) * args.stride;
+    for (int x = x0; x < x1; ++x, rgb += 3) {
+        const std::ptrdiff_t c     = row + x;
+        const float          total = args.deposit[c] + args.pigment[c];
+        const float          paper = 1.0f - args.heightMap[c] * args.paperRelief;
+        const float          cover = (1.0f - total) * paper;
+        for (int k = 0; k < 3; ++k)
+            rgb[k] = (args.depositColor[k][c] + args.surfaceColor[k][c]) + cover;
+    }
+}
+
+void packSrgba8RowScalar(const float* rgba, uint32_t* out, int texels) {
+    const float* table = srgbEncodeTable();
+    const float  scale = static_cast<float>(k_srgbTableSize - 1);
+    for (int t = 0; t < texels; ++t) {
+        uint32_t texel = 0;
+        for (int c = 0; c < 4; ++c) {
+            // 벡터 max/min과 같은 비교 순서 (NaN → 0)
+            float v = rgba[4 * t + c];
+            v = v > 0.0f ? v : 0.0f;
+            v = v < 1.0f ? v : 1.0f;
+            const int code = c < 3 ? static_cast<int>(table[static_cast<int>(v * scale + 0.5f)])
+                                   : static_cast<int>(v * 255.0f + 0.5f);
+            texel |= static_cast<uint32_t>(code) << (8 * c);
+        }
+        out[t] = texel;
+    }
+}
+
+// float → half 비트 (가장 가까운 짝수로 반올림, 범위 밖은 Inf, NaN은 qNaN)
+uint16_t toHalf(float value) {
+    constexpr uint32_t k_f16Max      = (127 + 16) << 23;  // 이 이상은 half로 Inf
+    constexpr uint32_t k_f32Inf      = 255u << 23;
+    constexpr uint32_t k_minNormal   = 113u << 23;        // half 최소 정규수 2^-14
+    constexpr uint32_t k_denormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint32_t half;
+    if (bits >= k_f16Max) {
+        half = bits > k_f32Inf ? 0x7E00u : 0x7C00u;
+    } else if (bits < k_minNormal) {
+        // 비정규: 매직 수를 더해 가수 아래쪽으로 밀어 부동소수 덧셈의 반올림을 그대로 사용
+        float magic, sum;
+        std::memcpy(&magic, &k_denormMagic, sizeof(magic));
+        std::memcpy(&sum, &bits, sizeof(sum));
+        sum += magic;
+        std::memcpy(&half, &sum, sizeof(half));
+        half -= k_denormMagic;
+    } else {
+        const uint32_t odd = (bits >> 13) & 1u;
+        half = (bits + (static_cast<uint32_t>(15 - 127) << 23) + 0xFFFu + odd) >> 13;
+    }
+    return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+void packHalfRowScalar(const float* src, uint16_t* out, int count) {
+    for (int i = 0; i < count; ++i) out[i] = toHalf(src[i]);
+}
+
+const SimdKernels k_scalar = {
+    SimdLevel::Scalar, diffuseRowScalar, advectRowScalar, surfaceLayerRowScalar, waterFluxRowScalar,
+    compositeRowScalar, packSrgba8RowScalar, packHalfRowScalar
+};
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;  // OS가 YMM 상태 저장
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool cpuHasSse42() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#else
+    return false;
+#endif
+}
+
+} // anonymous namespace
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Auto:   return "auto";
+    case SimdLevel::Scalar: return "scalar";
+    case SimdLevel::SSE42:  return "sse4.2";
+    case SimdLevel::AVX2:   return "avx2";
+    }
+    return "?";
+}
+
+const SimdKernels& scalarKernels() { return k_scalar; }
+
+const float* srgbEncodeTable() {
+    static const std::array<float, k_srgbTableSize> table = [] {
+        std::array<float, k_srgbTableSize> codes{};
+        for (int i = 0; i < k_srgbTableSize; ++i) {
+            const double linear  = static_cast<double>(i) / (k_srgbTableSize - 1);
+            const double encoded = linear <= 0.0031308 ? 12.92 * linear
+                                                       : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            codes[i] = static_cast<float>(std::floor(encoded * 255.0 + 0.5));
+        }
+        return codes;
+    }();
+    return table.data();
+}
+
+SimdLevel detectSimdLevel() {
+    static const SimdLevel detected = [] {
+        if (avx2Kernels()  && cpuHasAvx2())  return SimdLevel::AVX2;
+        if (sse42Kernels() && cpuHasSse42()) return SimdLevel::SSE42;
+        return SimdLevel::Scalar;
+    }();
+    return detected;
+}
+
+const SimdKernels& simdKernels(SimdLevel level) {
+    const SimdLevel best = detectSimdLevel();
+    if (level == SimdLevel::Auto || static_cast<int>(level) > static_cast<int>(best))
+        level = best;
+
+    if (level == SimdLevel::AVX2  && avx2Kernels())  return *avx2Kernels();
+    if (level == SimdLevel::SSE42 && sse42Kernels()) return *sse42Kernels();
+    return k_scalar;
+}
@@ -0,0 +1,131 @@
+//
+// SimdKernels.h
+// WaterColorSimulation
+//
+// 핫 루프(확산 스윕, 이류, 표면층 교환, CPU 합성)와 화면 타일 업로드 변환의 행 단위 커널 테이블.
+// 스칼라 / SSE4.2 / AVX2 구현이 같은 인터페이스를 갖고, 실행 시 CPUID로 지원되는
+// 가장 넓은 구현을 고른다. 벡터 구현은 스칼라와 같은 순서로 같은 연산을 하므로
+// (FMA 미사용) 결과가 비트 단위로 같다. 스칼라 구현은 검증용으로 항상 유지.
+//
+// 커널은 SoA 평면(PlanarField) 위에서 한 행의 [x0, x1) 구간을 처리하며,
+// 행 분배/활성 타일 순회는 호출 측(Simulation)이 담당한다.
+// 행 오프셋은 64비트로 계산하지만, 벡터 gather의 레인 인덱스는 평면 안의 32비트 오프셋이므로
+// 한 평면은 2^31셀 미만이어야 한다 (Grid::k_maxSide).
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 커널 구현 수준
+enum class SimdLevel : int {
+    Auto   = 0,  // 지원되는 가장 넓은 구현
+    Scalar = 1,
+    SSE42  = 2,
+    AVX2   = 3,
+};
+
+const char* simdLevelName(SimdLevel level);
+
+// 한 번의 커널 호출로 함께 처리하는 최대 성분 평면 수 (안료 농도 + 색상 RGB)
+constexpr int k_maxPlanes = 4;
+
+// sRGB 인코딩 표: [0, 1] 값을 k_srgbTableSize - 1 간격으로 양자화한 인덱스 → 8비트 코드
+// (float로 저장해 벡터 gather로 읽음). 정확한 변환과의 차이는 최대 1코드.
+constexpr int k_srgbTableSize = 4096;
+const float* srgbEncodeTable();
+
+// 이류 입력: 성분 planes개를 같은 출발점에서 쌍선형 샘플링.
+// 포인터는 셀 (0, 0), 인덱스 = y * stride + x. 출발점은 [0, width-1] × [0, height-1]로
+// 클램프하고 +1 이웃은 유령 셀을 읽으므로 src는 유령 셀 1칸 이상이 채워져 있어야 함.
+struct AdvectArgs {
+    const float* src[3];
+    float*       dst[3];
+    int          planes;
+    const float* velU;
+    const float* velV;
+    int          width;
+    int          height;
+    int          stride;
+    float        dt;
+};
+
+// 표면층 흡착/탈착 입력 (포인터는 셀 (0, 0), 인덱스 = y * stride + x)
+struct SurfaceLayerArgs {
+    float*       pigment;
+    float*       deposit;
+    const float* heightMap;
+    const float* evaporation;
+    const float* wetAreaMask;
+    float*       surfaceColor[3];
+    float*       depositColor[3];
+    int          stride;
+    float        granulation;
+    float        density;
+    float        staining;
+};
+
+// 보존적 이류(물, 안료 농도)의 면 플럭스 입력 (포인터는 셀 (0, 0), 인덱스 = y * stride + x)
+struct WaterFluxArgs {
+    const float* field;
+    float*       out;       // field + 면 플럭스 합 (field와 다른 버퍼)
+    const float* velU;
+    const float* velV;
+    const float* mask;
+    int          stride;
+    float        dt;
+    float        maxValue;  // 셀당 최대/최소 양 (이동량 제한)
+    float        minValue;
+};
+
+// 최종 합성(DisplayMode::Composite) 입력 (포인터는 셀 (0, 0), 인덱스 = y * stride + x).
+// out = 침착색 + 수면색 + (1 - (침착 농도 + 수면 농도)) × 종이 밝기
+struct CompositeArgs {
+    const float* pigment;
+    const float* deposit;
+    const float* heightMap;
+    const float* surfaceColor[3];
+    const float* depositColor[3];
+    int          stride;
+    float        paperRelief;  // 종이 밝기 = 1 - 높이 × paperRelief (Grid::paperShade)
+};
+
+struct SimdKernels {
+    SimdLevel level;
+
+    // 적색-흑색 스윕 한 행: (x + parity)가 짝수이고 mask != 0인 셀을 성분 planes개
+    // (<= k_maxPlanes) 모두 u = (b + a * (좌 + 우 + 상 + 하)) / diag 로 갱신.
+    // 포인터는 행 시작, stride는 행 간격. 마스크/색 판정은 셀마다 한 번만 함.
+    // 반환: 모든 성분 갱신량의 max 절댓값
+    float (*diffuseRow)(float* const* u, const float* const* b, int planes, const float* mask,
+                        int stride, int x0, int x1, int parity, float a, float diag);
+
+    // 세미-라그랑지안 이류 한 행: dst[y][x] = src(출발점 (x, y) - dt * vel)
+    void (*advectRow)(const AdvectArgs& args, int y, int x0, int x1);
+
+    // 표면층 교환 한 행 (wetAreaMask != 0인 셀만)
+    void (*surfaceLayerRow)(const SurfaceLayerArgs& args, int y, int x0, int x1);
+
+    // 보존적 면 플럭스 한 행: out = field + 네 면의 유입/유출 (격자 내부 셀만 호출)
+    void (*waterFluxRow)(const WaterFluxArgs& args, int y, int x0, int x1);
+
+    // 최종 합성 한 행: 셀 [x0, x1)을 rgb (RGB 교차, x1 - x0 텍셀)에 기록.
+    // 다섯 필드를 한 번씩 순서대로 읽는 스트리밍 패스.
+    void (*compositeRow)(const CompositeArgs& args, int y, int x0, int x1, float* rgb);
+
+    // 화면 타일 업로드 변환. 8비트: RGBA float texels개를 [0, 1]로 클램프해 RGB는 sRGB 인코딩
+    // (srgbEncodeTable), 알파는 선형. half: float count개를 가장 가까운 짝수로 반올림.
+    void (*packSrgba8Row)(const float* rgba, uint32_t* out, int texels);
+    void (*packHalfRow)(const float* src, uint16_t* out, int count);
+};
+
+// CPU가 지원하는 가장 넓은 수준
+SimdLevel detectSimdLevel();
+
+// 요청 수준의 커널 테이블. Auto 또는 지원되지 않는 수준이면 그 이하에서 가장 넓은 것.
+const SimdKernels& simdKernels(SimdLevel level);
+
+// 수준별 구현 (빌드 대상이 x86이 아니면 벡터 버전은 nullptr)
+const SimdKernels& scalarKernels();
+const SimdKernels* sse42Kernels();
+const SimdKernels* avx2Kernels();
@@ -0,0 +1,89 @@
+//
+// SimdKernelsAvx2.cpp
+// WaterColorSimulation
+//
+// AVX2 (8 레인) 커널. 이 파일만 -mavx2 (/arch:AVX2)로 컴파일된다.
+// FMA는 켜지 않는다: 곱셈-덧셈 융합은 반올림이 달라 스칼라 결과와 비트 단위로 달라짐.
+//
+#include "SimdKernels.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace {
+
+struct Avx2 {
+    static constexpr int W = 8;
+    using F = __m256;
+    using I = __m256i;
+
+    static F    load(const float* p)  { return _mm256_loadu_ps(p); }
+    static void store(float* p, F v)  { _mm256_storeu_ps(p, v); }
+    static F    set1(float v)         { return _mm256_set1_ps(v); }
+    static F    zero()                { return _mm256_setzero_ps(); }
+    static F    add(F a, F b)         { return _mm256_add_ps(a, b); }
+    static F    sub(F a, F b)         { return _mm256_sub_ps(a, b); }
+    static F    mul(F a, F b)         { return _mm256_mul_ps(a, b); }
+    static F    div(F a, F b)         { return _mm256_div_ps(a, b); }
+    static F    min(F a, F b)         { return _mm256_min_ps(a, b); }  // a < b ? a : b
+    static F    max(F a, F b)         { return _mm256_max_ps(a, b); }  // a > b ? a : b
+    static F    abs(F a)              { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static F    floor(F a)            { return _mm256_floor_ps(a); }
+    static F    nonZero(F a)          { return _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_NEQ_UQ); }
+    static F    greater(F a, F b)     { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static F    andMask(F a, F b)     { return _mm256_and_ps(a, b); }
+    static F    select(F m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+    static F    laneOffsets()         { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+
+    // odd = 0: 짝수 번째 레인, odd = 1: 홀수 번째 레인
+    static F evenLanes(int odd) {
+        const __m256i even = _mm256_setr_epi32(-1, 0, -1, 0, -1, 0, -1, 0);
+        const __m256i lanes = odd ? _mm256_setr_epi32(0, -1, 0, -1, 0, -1, 0, -1) : even;
+        return _mm256_castsi256_ps(lanes);
+    }
+
+    // 레인 4k+3 (RGBA 텍셀을 이어 담은 벡터의 알파)
+    static F alphaLanes() {
+        return _mm256_castsi256_ps(_mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1));
+    }
+
+    static float hmax(F v) {
+        __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+        m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+        return _mm_cvtss_f32(m);
+    }
+
+    static I iset1(int v)              { return _mm256_set1_epi32(v); }
+    static I iadd(I a, I b)            { return _mm256_add_epi32(a, b); }
+    static I imul(I a, I b)            { return _mm256_mullo_epi32(a, b); }
+    static I toInt(F a)                { return _mm256_cvttps_epi32(a); }
+    static void istore(int* p, I v)    { _mm256_storeu_si256(reinterpret_cast<I*>(p), v); }
+    static I bits(F a)                 { return _mm256_castps_si256(a); }
+    static F fromBits(I a)             { return _mm256_castsi256_ps(a); }
+    static I iand(I a, I b)            { return _mm256_and_si256(a, b); }
+    static I ior(I a, I b)             { return _mm256_or_si256(a, b); }
+    static I ixor(I a, I b)            { return _mm256_xor_si256(a, b); }
+    static I isub(I a, I b)            { return _mm256_sub_epi32(a, b); }
+    static I igreater(I a, I b)        { return _mm256_cmpgt_epi32(a, b); }  // 부호 있는 비교
+    static I iselect(I m, I a, I b)    { return _mm256_blendv_epi8(b, a, m); }
+    template<int N>
+    static I srli(I a)                 { return _mm256_srli_epi32(a, N); }
+    static F gather(const float* base, I idx) { return _mm256_i32gather_ps(base, idx, 4); }
+};
+
+} // anonymous namespace
+
+#include "SimdKernelsBody.h"
+
+const SimdKernels* avx2Kernels() {
+    static const SimdKernels kernels = simd_body::makeKernels<Avx2>(SimdLevel::AVX2);
+    return &kernels;
+}
+
+#else
+
+const SimdKernels* avx2Kernels() { return nullptr; }
+
+#endif
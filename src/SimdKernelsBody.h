@@ -0,0 +1,351 @@
+//
+// SimdKernelsBody.h
+// WaterColorSimulation
+//
+// SimdKernels의 벡터 구현 본문. SimdKernelsSse42.cpp / SimdKernelsAvx2.cpp가
+// 명령어 집합별 래퍼 V(익명 네임스페이스)를 정의한 뒤 포함한다.
+// V는 폭 W와 float 벡터(F)/정수 벡터(I) 연산을 제공한다.
+//
+// 주의: 이 헤더는 -mavx2 등 ISA 플래그로 컴파일되는 파일에서만 포함할 것.
+// 표준 라이브러리 인라인 함수를 쓰면 ISA별 인스턴스가 링크 시 섞일 수 있으므로
+// 본문은 내장 함수(intrinsics)와 V만 사용하고, 나머지 꼬리 구간은 스칼라 커널에 넘긴다.
+//
+#pragma once
+
+#include "SimdKernels.h"
+
+namespace simd_body {
+
+// 적색-흑색 스윕 한 행. 한 색의 셀만 다른 색 이웃을 읽으므로 W칸을 통째로 계산한 뒤
+// 해당 색이면서 젖은 레인만 기록해도 스칼라 순차 갱신과 결과가 같다.
+template<class V>
+float diffuseRow(float* const* u, const float* const* b, int planes, const float* mask,
+                 int stride, int x0, int x1, int parity, float a, float diag) {
+    using F = typename V::F;
+    const F va     = V::set1(a);
+    const F vdiag  = V::set1(diag);
+    const F colour = V::evenLanes((x0 + parity) & 1);  // (x + parity)가 짝수인 레인
+    F       change = V::zero();
+
+    int x = x0;
+    F   left[k_maxPlanes];
+    if (x + V::W <= x1)
+        for (int p = 0; p < planes; ++p) left[p] = V::load(u[p] + x - 1);
+    for (; x + V::W <= x1; x += V::W) {
+        const F sel = V::andMask(colour, V::nonZero(V::load(mask + x)));
+        for (int p = 0; p < planes; ++p) {
+            float*  f   = u[p];
+            const F old = V::load(f + x);
+            const F sum = V::add(V::add(V::add(left[p], V::load(f + x + 1)),
+                                        V::load(f + x - stride)),
+                                 V::load(f + x + stride));
+            const F updated = V::div(V::add(V::load(b[p] + x), V::mul(va, sum)), vdiag);
+            change = V::max(change, V::andMask(sel, V::abs(V::sub(updated, old))));
+
+            // 다음 묶음의 왼쪽 이웃(x+W-1부터)은 이번 저장과 한 칸 겹치므로 저장 전에 읽어
+            // 저장→적재 전달 실패 지연을 피함. 겹친 칸 x+W-1이 이번에 갱신된다면 그 칸을
+            // 이웃으로 쓰는 x+W는 다른 색이라 기록되지 않으므로 결과가 같다.
+            if (x + 2 * V::W <= x1) left[p] = V::load(f + x + V::W - 1);
+            V::store(f + x, V::select(sel, updated, old));
+        }
+    }
+
+    float result = V::hmax(change);
+    if (x < x1) {
+        const float tail = scalarKernels().diffuseRow(u, b, planes, mask, stride,
+                                                      x, x1, parity, a, diag);
+        if (tail > result) result = tail;
+    }
+    return result;
+}
+
+// 세미-라그랑지안 이류 한 행. 출발점/가중치를 한 번 계산해 모든 성분 평면에 사용.
+template<class V>
+void advectRow(const AdvectArgs& args, int y, int x0, int x1) {
+    using F = typename V::F;
+    using I = typename V::I;
+    const int w    = args.stride;
+    const F   wx   = V::set1(static_cast<float>(args.width  - 1) - 1e-6f);
+    const F   wy   = V::set1(static_cast<float>(args.height - 1) - 1e-6f);
+    const F   zero = V::zero();
+    const F   one  = V::set1(1.0f);
+    const F   dt   = V::set1(args.dt);
+    const F   fy   = V::set1(static_cast<float>(y));
+    const I   vw   = V::iset1(w);
+
+    int x = x0;
+    for (; x + V::W <= x1; x += V::W) {
+        const std::ptrdiff_t c  = static_cast<std::ptrdiff_t>(y) * w + x;
+        const F              fx = V::add(V::set1(static_cast<float>(x)), V::laneOffsets());
+
+        // 클램프: min(p, w) → max(·, 0) (스칼라의 삼항 연산과 같은 선택 규칙)
+        F px = V::sub(fx, V::mul(dt, V::load(args.velU + c)));
+        F py = V::sub(fy, V::mul(dt, V::load(args.velV + c)));
+        px = V::max(V::min(px, wx), zero);
+        py = V::max(V::min(py, wy), zero);
+
+        const F flx = V::floor(px);
+        const F fly = V::floor(py);
+        const F s   = V::sub(px, flx);
+        const F t   = V::sub(py, fly);
+        const F s1  = V::sub(one, s);
+        const F t1  = V::sub(one, t);
+
+        // +1 이웃은 유령 셀까지 읽으므로 클램프 없이 고정 오프셋(+1, +w)으로 모음
+        const I i00 = V::iadd(V::imul(V::toInt(fly), vw), V::toInt(flx));
+
+        for (int p = 0; p < args.planes; ++p) {
+            const float* f  = args.src[p];
+            const F      v0 = V::add(V::mul(V::gather(f, i00), s1),
+                                     V::mul(V::gather(f + 1, i00), s));
+            const F      v1 = V::add(V::mul(V::gather(f + w, i00), s1),
+                                     V::mul(V::gather(f + w + 1, i00), s));
+            V::store(args.dst[p] + c, V::add(V::mul(v0, t1), V::mul(v1, t)));
+        }
+    }
+
+    if (x < x1) scalarKernels().advectRow(args, y, x, x1);
+}
+
+// 표면층 흡착/탈착 한 행. 분기는 모두 레인 선택으로 바꾸고, 건조 셀은 원래 값을 다시 기록.
+template<class V>
+void surfaceLayerRow(const SurfaceLayerArgs& args, int y, int x0, int x1) {
+    using F = typename V::F;
+    const F zero     = V::zero();
+    const F one      = V::set1(1.0f);
+    const F three    = V::set1(3.0f);
+    const F minConc  = V::set1(0.001f);
+    const F gran     = V::set1(args.granulation);
+    const F density  = V::set1(args.density);
+    const F staining = V::set1(args.staining);
+
+    const std::ptrdiff_t row = static_cast<std::ptrdiff_t>(y) * args.stride;
+    int x = x0;
+    for (; x + V::W <= x1; x += V::W) {
+        const std::ptrdiff_t c = row + x;
+
+        const F   wet     = V::nonZero(V::load(args.wetAreaMask + c));
+        const F   pigment = V::load(args.pigment + c);
+        const F   deposit = V::load(args.deposit + c);
+        const F   height  = V::load(args.heightMap + c);
+
+        const F boundaryFactor =
+            V::add(one, V::mul(V::max(V::sub(one, V::load(args.evaporation + c)), zero), three));
+
+        F adsorb = V::mul(V::mul(V::mul(pigment, V::sub(one, V::mul(height, gran))), density),
+                          boundaryFactor);
+        F desorb = V::div(V::mul(V::mul(deposit, V::sub(one, V::mul(V::sub(one, height), gran))),
+                                 density),
+                          staining);
+
+        adsorb = V::select(V::greater(V::add(deposit, adsorb), one),
+                           V::max(V::sub(one, deposit), zero), adsorb);
+        desorb = V::select(V::greater(V::add(pigment, desorb), one),
+                           V::max(V::sub(one, pigment), zero), desorb);
+
+        const F toDeposit = V::andMask(V::andMask(wet, V::greater(adsorb, zero)),
+                                       V::greater(pigment, minConc));
+        const F toSurface = V::andMask(V::andMask(wet, V::greater(desorb, zero)),
+                                       V::greater(deposit, minConc));
+        const F ratioA = V::div(adsorb, pigment);   // 선택되지 않은 레인의 inf/NaN은 버려짐
+        const F ratioD = V::div(desorb, deposit);
+
+        for (int p = 0; p < 3; ++p) {
+            F sc = V::load(args.surfaceColor[p] + c);
+            F dc = V::load(args.depositColor[p] + c);
+
+            const F ta = V::mul(sc, ratioA);
+            dc = V::select(toDeposit, V::add(dc, ta), dc);
+            sc = V::select(toDeposit, V::sub(sc, ta), sc);
+
+            const F td = V::mul(dc, ratioD);
+            sc = V::select(toSurface, V::add(sc, td), sc);
+            dc = V::select(toSurface, V::sub(dc, td), dc);
+
+            V::store(args.surfaceColor[p] + c, sc);
+            V::store(args.depositColor[p] + c, dc);
+        }
+
+        V::store(args.deposit + c,
+                 V::select(wet, V::add(deposit, V::sub(adsorb, desorb)), deposit));
+        V::store(args.pigment + c,
+                 V::select(wet, V::add(pigment, V::sub(desorb, adsorb)), pigment));
+    }
+
+    if (x < x1) scalarKernels().surfaceLayerRow(args, y, x, x1);
+}
+
+// 면 이동량 제한 min(|hi - a|, min(|flux|, |lo - b|)).
+// std::min(p, q)는 (q < p ? q : p)이므로 V::min(q, p)로 옮겨 피연산자 선택 규칙을 맞춤.
+template<class V>
+typename V::F limitFlux(typename V::F hi, typename V::F lo, typename V::F flux,
+                        typename V::F a, typename V::F b) {
+    return V::min(V::min(V::abs(V::sub(lo, b)), V::abs(flux)), V::abs(V::sub(hi, a)));
+}
+
+// 보존적 면 플럭스 한 행. 면마다 두 분기를 모두 계산하고 속도 부호로 선택
+// (스칼라와 같은 면 순서로 field 값에 누적해 out에 기록).
+template<class V>
+void waterFluxRow(const WaterFluxArgs& args, int y, int x0, int x1) {
+    using F = typename V::F;
+    const int    s     = args.stride;
+    const float* field = args.field;
+    const float* mask  = args.mask;
+    const float* velU  = args.velU;
+    const float* velV  = args.velV;
+    const F zero    = V::zero();
+    const F half    = V::set1(0.5f);
+    const F quarter = V::set1(0.25f);  // x / 4와 x * 0.25는 같은 값으로 반올림됨
+    const F dt      = V::set1(args.dt);
+    const F hi      = V::set1(args.maxValue);
+    const F lo      = V::set1(args.minValue);
+
+    // 면 속도 × dt × 보낼 쪽 양 / 4
+    auto flux = [&](F vel, F from) { return V::mul(V::mul(V::mul(vel, dt), from), quarter); };
+
+    int x = x0;
+    for (; x + V::W <= x1; x += V::W) {
+        const std::ptrdiff_t c = static_cast<std::ptrdiff_t>(y) * s + x;
+        const F              m = V::load(mask + c);
+        const F   u = V::load(velU + c);
+        const F   v = V::load(velV + c);
+
+        // 면 중심 속도: 인접 셀 평균, 건조 경계는 0으로 차단
+        const F vx1 = V::mul(V::mul(V::mul(m, V::load(mask + c + 1)), V::add(u, V::load(velU + c + 1))), half);
+        const F vx2 = V::mul(V::mul(V::mul(m, V::load(mask + c - 1)), V::add(u, V::load(velU + c - 1))), half);
+        const F vy1 = V::mul(V::mul(V::mul(m, V::load(mask + c + s)), V::add(v, V::load(velV + c + s))), half);
+        const F vy2 = V::mul(V::mul(V::mul(m, V::load(mask + c - s)), V::add(v, V::load(velV + c - s))), half);
+
+        const F f   = V::load(field + c);
+        const F fxp = V::load(field + c + 1);
+        const F fxm = V::load(field + c - 1);
+        const F fyp = V::load(field + c + s);
+        const F fym = V::load(field + c - s);
+        F       t   = f;
+
+        // +x 면
+        t = V::select(V::greater(vx1, zero),
+                      V::sub(t, limitFlux<V>(hi, lo, flux(vx1, f),   fxp, f)),
+                      V::add(t, limitFlux<V>(hi, lo, flux(vx1, fxp), f,   fxm)));
+        // -x 면
+        t = V::select(V::greater(vx2, zero),
+                      V::add(t, limitFlux<V>(hi, lo, flux(vx2, fxm), f,   fxm)),
+                      V::sub(t, limitFlux<V>(hi, lo, flux(vx2, f),   fxm, f)));
+        // +y 면
+        t = V::select(V::greater(vy1, zero),
+                      V::sub(t, limitFlux<V>(hi, lo, flux(vy1, f),   f,   fym)),
+                      V::add(t, limitFlux<V>(hi, lo, flux(vy1, fyp), fym, f)));
+        // -y 면
+        t = V::select(V::greater(vy2, zero),
+                      V::add(t, limitFlux<V>(hi, lo, flux(vy2, fym), fyp, f)),
+                      V::sub(t, limitFlux<V>(hi, lo, flux(vy2, f),   f,   fyp)));
+
+        V::store(args.out + c, t);
+    }
+
+    if (x < x1) scalarKernels().waterFluxRow(args, y, x, x1);
+}
+
+// 이 ISA의 커널 테이블
+// 최종 합성 한 행. 평면별 벡터로 계산한 뒤 RGB로 교차해 기록.
+template<class V>
+void compositeRow(const CompositeArgs& args, int y, int x0, int x1, float* rgb) {
+    using F = typename V::F;
+    const F one    = V::set1(1.0f);
+    const F relief = V::set1(args.paperRelief);
+
+    const std::ptrdiff_t row = static_cast<std::ptrdiff_t>(y) * args.stride;
+    int x = x0;
+    for (; x + V::W <= x1; x += V::W, rgb += 3 * V::W) {
+        const std::ptrdiff_t c     = row + x;
+        const F              total = V::add(V::load(args.deposit + c), V::load(args.pigment + c));
+        const F              paper = V::sub(one, V::mul(V::load(args.heightMap + c), relief));
+        const F              cover = V::mul(V::sub(one, total), paper);
+
+        float channel[3][V::W];
+        for (int k = 0; k < 3; ++k)
+            V::store(channel[k], V::add(V::add(V::load(args.depositColor[k] + c),
+                                               V::load(args.surfaceColor[k] + c)), cover));
+        for (int i = 0; i < V::W; ++i) {
+            rgb[3 * i]     = channel[0][i];
+            rgb[3 * i + 1] = channel[1][i];
+            rgb[3 * i + 2] = channel[2][i];
+        }
+    }
+    if (x < x1) scalarKernels().compositeRow(args, y, x, x1, rgb);
+}
+
+// 화면 타일 RGBA8 변환. W는 4의 배수라 벡터마다 레인 4k+3이 알파: 모든 레인을 sRGB 코드와
+// 선형 코드 둘 다로 바꾼 뒤 레인별로 고른다.
+template<class V>
+void packSrgba8Row(const float* rgba, uint32_t* out, int texels) {
+    using F = typename V::F;
+    const float* table  = srgbEncodeTable();
+    const F      scale  = V::set1(static_cast<float>(k_srgbTableSize - 1));
+    const F      linear = V::set1(255.0f);
+    const F      half   = V::set1(0.5f);
+    const F      zero   = V::zero();
+    const F      one    = V::set1(1.0f);
+    const F      alpha  = V::alphaLanes();
+
+    int t = 0;
+    for (; t + V::W <= texels; t += V::W) {
+        int codes[4 * V::W];
+        for (int k = 0; k < 4; ++k) {
+            const F v    = V::min(V::max(V::load(rgba + 4 * t + k * V::W), zero), one);
+            const F srgb = V::gather(table, V::toInt(V::add(V::mul(v, scale), half)));
+            const F lin  = V::add(V::mul(v, linear), half);
+            V::istore(codes + k * V::W, V::toInt(V::select(alpha, lin, srgb)));
+        }
+        for (int i = 0; i < V::W; ++i)
+            out[t + i] = static_cast<uint32_t>(codes[4 * i])
+                       | static_cast<uint32_t>(codes[4 * i + 1]) << 8
+                       | static_cast<uint32_t>(codes[4 * i + 2]) << 16
+                       | static_cast<uint32_t>(codes[4 * i + 3]) << 24;
+    }
+    if (t < texels) scalarKernels().packSrgba8Row(rgba + 4 * t, out + t, texels - t);
+}
+
+// float → half. 스칼라 toHalf와 같은 비트 연산을 레인마다 (분기 대신 선택).
+template<class V>
+void packHalfRow(const float* src, uint16_t* out, int count) {
+    using I = typename V::I;
+    const I signMask    = V::iset1(static_cast<int>(0x80000000u));
+    const I f16Max      = V::iset1(((127 + 16) << 23) - 1);  // 초과면 Inf/NaN
+    const I f32Inf      = V::iset1(255 << 23);
+    const I minNormal   = V::iset1(113 << 23);
+    const I denormMagic = V::iset1(((127 - 15) + (23 - 10) + 1) << 23);
+    const I rebias      = V::iset1(static_cast<int>((static_cast<unsigned>(15 - 127) << 23) + 0xFFFu));
+    const I oneBit      = V::iset1(1);
+    const I qnan        = V::iset1(0x7E00);
+    const I inf         = V::iset1(0x7C00);
+
+    int i = 0;
+    for (; i + V::W <= count; i += V::W) {
+        const I raw  = V::bits(V::load(src + i));
+        const I sign = V::iand(raw, signMask);
+        const I mag  = V::ixor(raw, sign);
+
+        const I special = V::iselect(V::igreater(mag, f32Inf), qnan, inf);
+        const I denorm  = V::isub(V::bits(V::add(V::fromBits(mag), V::fromBits(denormMagic))),
+                                  denormMagic);
+        const I odd     = V::iand(V::template srli<13>(mag), oneBit);
+        const I normal  = V::template srli<13>(V::iadd(V::iadd(mag, rebias), odd));
+
+        I h = V::iselect(V::igreater(minNormal, mag), denorm, normal);
+        h   = V::iselect(V::igreater(mag, f16Max), special, h);
+
+        int halves[V::W];
+        V::istore(halves, V::ior(h, V::template srli<16>(sign)));
+        for (int k = 0; k < V::W; ++k) out[i + k] = static_cast<uint16_t>(halves[k]);
+    }
+    if (i < count) scalarKernels().packHalfRow(src + i, out + i, count - i);
+}
+
+template<class V>
+SimdKernels makeKernels(SimdLevel level) {
+    return { level, diffuseRow<V>, advectRow<V>, surfaceLayerRow<V>, waterFluxRow<V>,
+             compositeRow<V>, packSrgba8Row<V>, packHalfRow<V> };
+}
+
+} // namespace simd_body
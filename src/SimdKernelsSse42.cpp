@@ -0,0 +1,92 @@
+//
+// SimdKernelsSse42.cpp
+// WaterColorSimulation
+//
+// SSE4.2 (4 레인) 커널. 이 파일만 -msse4.2로 컴파일된다 (MSVC x64는 플래그 불필요).
+// SSE에는 gather가 없으므로 이류 샘플은 레인별 스칼라 로드로 채운다.
+//
+#include "SimdKernels.h"
+
+#if defined(__SSE4_2__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+
+#include <nmmintrin.h>
+
+namespace {
+
+struct Sse42 {
+    static constexpr int W = 4;
+    using F = __m128;
+    using I = __m128i;
+
+    static F    load(const float* p)  { return _mm_loadu_ps(p); }
+    static void store(float* p, F v)  { _mm_storeu_ps(p, v); }
+    static F    set1(float v)         { return _mm_set1_ps(v); }
+    static F    zero()                { return _mm_setzero_ps(); }
+    static F    add(F a, F b)         { return _mm_add_ps(a, b); }
+    static F    sub(F a, F b)         { return _mm_sub_ps(a, b); }
+    static F    mul(F a, F b)         { return _mm_mul_ps(a, b); }
+    static F    div(F a, F b)         { return _mm_div_ps(a, b); }
+    static F    min(F a, F b)         { return _mm_min_ps(a, b); }  // a < b ? a : b
+    static F    max(F a, F b)         { return _mm_max_ps(a, b); }  // a > b ? a : b
+    static F    abs(F a)              { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static F    floor(F a)            { return _mm_floor_ps(a); }
+    static F    nonZero(F a)          { return _mm_cmpneq_ps(a, _mm_setzero_ps()); }
+    static F    greater(F a, F b)     { return _mm_cmpgt_ps(a, b); }
+    static F    andMask(F a, F b)     { return _mm_and_ps(a, b); }
+    static F    select(F m, F a, F b) { return _mm_blendv_ps(b, a, m); }
+    static F    laneOffsets()         { return _mm_setr_ps(0, 1, 2, 3); }
+
+    // odd = 0: 짝수 번째 레인, odd = 1: 홀수 번째 레인
+    static F evenLanes(int odd) {
+        return _mm_castsi128_ps(odd ? _mm_setr_epi32(0, -1, 0, -1)
+                                    : _mm_setr_epi32(-1, 0, -1, 0));
+    }
+
+    // 레인 4k+3 (RGBA 텍셀을 이어 담은 벡터의 알파)
+    static F alphaLanes() {
+        return _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+    }
+
+    static float hmax(F v) {
+        __m128 m = _mm_max_ps(v, _mm_movehl_ps(v, v));
+        m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+        return _mm_cvtss_f32(m);
+    }
+
+    static I iset1(int v)              { return _mm_set1_epi32(v); }
+    static I iadd(I a, I b)            { return _mm_add_epi32(a, b); }
+    static I imul(I a, I b)            { return _mm_mullo_epi32(a, b); }
+    static I toInt(F a)                { return _mm_cvttps_epi32(a); }
+    static void istore(int* p, I v)    { _mm_storeu_si128(reinterpret_cast<I*>(p), v); }
+    static I bits(F a)                 { return _mm_castps_si128(a); }
+    static F fromBits(I a)             { return _mm_castsi128_ps(a); }
+    static I iand(I a, I b)            { return _mm_and_si128(a, b); }
+    static I ior(I a, I b)             { return _mm_or_si128(a, b); }
+    static I ixor(I a, I b)            { return _mm_xor_si128(a, b); }
+    static I isub(I a, I b)            { return _mm_sub_epi32(a, b); }
+    static I igreater(I a, I b)        { return _mm_cmpgt_epi32(a, b); }  // 부호 있는 비교
+    static I iselect(I m, I a, I b)    { return _mm_blendv_epi8(b, a, m); }
+    template<int N>
+    static I srli(I a)                 { return _mm_srli_epi32(a, N); }
+    static F gather(const float* base, I idx) {
+        return _mm_setr_ps(base[_mm_cvtsi128_si32(idx)],
+                           base[_mm_extract_epi32(idx, 1)],
+                           base[_mm_extract_epi32(idx, 2)],
+                           base[_mm_extract_epi32(idx, 3)]);
+    }
+};
+
+} // anonymous namespace
+
+#include "SimdKernelsBody.h"
+
+const SimdKernels* sse42Kernels() {
+    static const SimdKernels kernels = simd_body::makeKernels<Sse42>(SimdLevel::SSE42);
+    return &kernels;
+}
+
+#else
+
+const SimdKernels* sse42Kernels() { return nullptr; }
+
+#endif
@@ -8,312 +8,774 @@
 #include "GaussianBlur.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <iostream>
+#include <type_traits>
+
+namespace {
+
+// 행 묶음별 부분 최댓값을 합침 (max는 순서와 무관 → 스레드 수와 상관없이 같은 결과)
+inline void atomicMax(std::atomic<float>& target, float value) {
+    float current = target.load(std::memory_order_relaxed);
+    while (value > current
+           && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+// 표시 모드별 셀 하나의 합성 (모드는 컴파일 시점에 고정 → 셀마다 분기 없음).
+// 사전 곱셈 합성: out = premulColor + (1 - 농도) × 종이색. field는 스칼라 모드의 평면
+template<DisplayMode Mode>
+inline void shadeCell(const Grid& grid, const float* field, std::ptrdiff_t idx, float* rgb) {
+    if constexpr (Mode == DisplayMode::Composite) {
+        const float total = grid.pigmentDeposit[idx] + grid.pigment[idx];
+        const float cover = (1.0f - total) * grid.paperShade(idx);
+        for (int c = 0; c < 3; ++c)
+            rgb[c] = (grid.depositColor.plane(c)[idx] + grid.surfaceColor.plane(c)[idx]) + cover;
+    } else if constexpr (Mode == DisplayMode::Deposit) {
+        const float cover = (1.0f - grid.pigmentDeposit[idx]) * grid.paperShade(idx);
+        for (int c = 0; c < 3; ++c) rgb[c] = grid.depositColor.plane(c)[idx] + cover;
+    } else if constexpr (Mode == DisplayMode::SurfacePigment) {
+        const float cover = (1.0f - grid.pigment[idx]) * grid.paperShade(idx);
+        for (int c = 0; c < 3; ++c) rgb[c] = grid.surfaceColor.plane(c)[idx] + cover;
+    } else {
+        rgb[0] = rgb[1] = rgb[2] = field[idx];
+    }
+}
+
+// updateRenderBuffer의 행 구간 [jBegin, jEnd). 열 i는 [0, iLo)가 왼쪽 가장자리 셀,
+// [iLo, iHi)가 캔버스 안 셀 first + i × step, [iHi, w)가 오른쪽 가장자리 셀.
+// 셀마다의 클램프 대신 구간 경계를 한 번 구해 두고, 최종 합성의 step 1 구간은 SIMD 커널로
+template<DisplayMode Mode>
+void renderRows(const Grid& grid, const SimdKernels& kernels, const CompositeArgs& args,
+                const float* field, const RenderRegion& region, int iLo, int iHi,
+                int jBegin, int jEnd, float* out) {
+    const int w     = region.width();
+    const int step  = region.step;
+    const int first = region.x0 + step / 2;
+    const int yMax  = grid.height - 1;
+    for (int j = jBegin; j < jEnd; ++j) {
+        const int            y    = std::clamp(region.y0 + j * step + step / 2, 0, yMax);
+        const std::ptrdiff_t row  = grid.index(0, y);
+        float* const         dst  = out + 3 * static_cast<size_t>(j) * w;
+        for (int i = 0; i < iLo; ++i) shadeCell<Mode>(grid, field, row, dst + 3 * i);
+        if (Mode == DisplayMode::Composite && step == 1) {
+            if (iLo < iHi) kernels.compositeRow(args, y, first + iLo, first + iHi, dst + 3 * iLo);
+        } else {
+            std::ptrdiff_t idx = row + first + static_cast<std::ptrdiff_t>(iLo) * step;
+            for (int i = iLo; i < iHi; ++i, idx += step) shadeCell<Mode>(grid, field, idx, dst + 3 * i);
+        }
+        for (int i = iHi; i < w; ++i) shadeCell<Mode>(grid, field, row + grid.width - 1, dst + 3 * i);
+    }
+}
+
+} // anonymous namespace
+
+const char* diffuseFieldName(DiffuseField field) {
+    switch (field) {
+    case DiffuseField::Velocity: return "Velocity";
+    case DiffuseField::Water:    return "Water";
+    case DiffuseField::Pigment:  return "Pigment";
+    case DiffuseField::Count:    break;
+    }
+    return "?";
+}
 
 Simulation::Simulation(Grid& grid, const SimulationParams& params)
-    : m_grid(grid), params(params) {}
+    : params(params), m_grid(grid),
+      m_scratch(grid.scratch, static_cast<size_t>(grid.cellCount()), Grid::k_scratchPlanes) {
+    m_tiles.resize(grid.width, grid.height);
+    if (this->params.threadCount <= 0)
+        this->params.threadCount = ThreadPool::hardwareThreads();
+    m_pool.resize(this->params.threadCount);
+    m_kernels = &simdKernels(this->params.simdLevel);
+}
+
+// 활성 구간을 행 묶음으로 나눠 스레드 풀에서 처리.
+// 셀마다 자기 자신만 쓰는 gather 커널 전용 (결과가 스레드 수와 무관).
+template<typename Fn>
+void Simulation::parallelRows(int yBegin, int yEnd, int xBegin, int xEnd, Fn&& fn) {
+    m_pool.parallelFor(yBegin, yEnd, [&](int b, int e) {
+        m_tiles.forEachRow(b, e, xBegin, xEnd, fn);
+    });
+}
+
+void Simulation::syncExecutionParams() {
+    const int threads = params.threadCount > 0 ? params.threadCount
+                                               : ThreadPool::hardwareThreads();
+    if (threads != m_pool.size()) m_pool.resize(threads);
+    m_kernels = &simdKernels(params.simdLevel);
+}
+
+// 가중치 w로 현재 값과 브러시 값을 섞음: v * (1 - w) + brush * w.
+// w = 1(단단한 브러시, 원판 안쪽)이면 결과는 정확히 브러시 값.
+void Simulation::stamp(float x, float y, const glm::vec3& pigmentColor) {
+    const int cx = static_cast<int>(x);
+    const int cy = static_cast<int>(y);
+    const int r  = m_brushMask.radius();
+
+    // 다음 스텝에서 도장 영역 타일을 검사하도록 표시
+    m_settled = false;
+    m_tiles.markRegion (cx - r, cy - r, cx + r + 1, cy + r + 1);
+    m_tiles.markChanged(cx - r, cy - r, cx + r + 1, cy + r + 1);
+
+    // 사전 곱셈(premultiplied) 저장: 색상 × 농도
+    // 빈 셀(색=0)과 이류 보간 시 색이 희석되지 않도록 하기 위함
+    const glm::vec3 color      = pigmentColor * params.pigmentAmount;
+    float* const    surface[3] = { m_grid.surfaceColor.plane(0),
+                                   m_grid.surfaceColor.plane(1),
+                                   m_grid.surfaceColor.plane(2) };
+    FloatPlane&     water      = m_grid.water;
+    FloatPlane&     pigment    = m_grid.pigment;
+    FloatPlane&     saturation = m_grid.saturation;
+
+    const int y0 = std::max(1, cy - r);
+    const int y1 = std::min(m_grid.height - 1, cy + r + 1);
+    for (int y = y0; y < y1; ++y) {
+        const int hw = m_brushMask.halfWidth(y - cy);
+        if (hw < 0) continue;
+        const float* weights = m_brushMask.row(y - cy);
+        const int    x0      = std::max(1, cx - hw);
+        const int    x1      = std::min(m_grid.width - 1, cx + hw + 1);
+        for (int x = x0; x < x1; ++x) {
+            const float          w    = weights[x - cx + r];
+            const float          keep = 1.0f - w;
+            const std::ptrdiff_t idx  = m_grid.index(x, y);
+            water[idx]              = water[idx]   * keep + params.waterAmount   * w;
+            pigment[idx]            = pigment[idx] * keep + params.pigmentAmount * w;
+            saturation[idx]         = params.wetMaskThreshold;
+            m_grid.wetAreaMask[idx] = 1.0f;
+            for (int p = 0; p < 3; ++p)
+                surface[p][idx] = surface[p][idx] * keep + color[p] * w;
+        }
+    }
+}
 
 // --- 공개 인터페이스 ----------------------------------------------------------
 
 void Simulation::applyBrush(float normX, float normY, bool isPressed,
                              const glm::vec3& pigmentColor) {
-    if (!isPressed) return;
-
-    const int cx = static_cast<int>(normX * m_grid.width);
-    const int cy = static_cast<int>(normY * m_grid.height);
-    const int r  = params.brushRadius;
-
-    for (int y = 1; y < m_grid.height - 1; ++y) {
-        for (int x = 1; x < m_grid.width - 1; ++x) {
-            const float dist = std::sqrt(static_cast<float>((cx - x) * (cx - x)
-                                                           + (cy - y) * (cy - y)));
-            if (dist < r) {
-                int idx = m_grid.index(x, y);
-                m_grid.water[idx]        = params.waterAmount;
-                m_grid.saturation[idx]   = params.wetMaskThreshold;
-                m_grid.wetAreaMask[idx]  = 1.0f;
-                m_grid.pigment[idx]      = params.pigmentAmount;
-                // 사전 곱셈(premultiplied) 저장: 색상 × 농도
-                // 빈 셀(색=0)과 이류 보간 시 색이 희석되지 않도록 하기 위함
-                m_grid.surfaceColor[idx] = pigmentColor * params.pigmentAmount;
-            }
+    if (!isPressed) {
+        m_strokeActive = false;
+        return;
+    }
+
+    ScopedTimer timer(profiler, ProfileStage::Brush);
+    m_brushMask.update(params.brushRadius, params.brushSoftness);
+    const glm::vec2 pos(normX * m_grid.width, normY * m_grid.height);
+
+    if (m_strokeActive) {
+        // 이전 도장과 현재 위치 사이를 spacing 이하 간격으로 균등 분할
+        // (이전 위치는 이미 찍었으므로 제외, 현재 위치는 아래에서 찍음)
+        const float     spacing = std::max(1.0f, params.brushSpacing * params.brushRadius);
+        const glm::vec2 delta   = pos - m_strokeLast;
+        const int       steps   = static_cast<int>(std::ceil(glm::length(delta) / spacing));
+        for (int i = 1; i < steps; ++i) {
+            const glm::vec2 p = m_strokeLast + delta * (static_cast<float>(i) / steps);
+            stamp(p.x, p.y, pigmentColor);
+        }
+    }
+
+    // 커서가 멈춰 있어도 매 프레임 현재 위치를 다시 적심
+    stamp(pos.x, pos.y, pigmentColor);
+    m_strokeActive = true;
+    m_strokeLast   = pos;
+}
+
+void Simulation::consumeInput(InputQueue& queue, double until,
+                              const glm::vec3& pigmentColor) {
+    bool stamped = false;
+    while (const InputEvent* event = queue.front()) {
+        if (event->time > until) break;
+        m_pointer = glm::vec2(event->normX, event->normY);
+        switch (event->type) {
+        case InputEvent::Type::Press:
+            m_pointerDown = true;
+            break;
+        case InputEvent::Type::Move:
+            break;
+        case InputEvent::Type::Release:
+            // 뗀 위치까지 스트로크를 이은 뒤 종료
+            if (m_pointerDown) applyBrush(m_pointer.x, m_pointer.y, true, pigmentColor);
+            m_pointerDown = false;
+            applyBrush(m_pointer.x, m_pointer.y, false, pigmentColor);
+            break;
+        }
+        if (m_pointerDown) {
+            applyBrush(m_pointer.x, m_pointer.y, true, pigmentColor);
+            stamped = true;
         }
+        queue.pop();
     }
+
+    if (m_pointerDown && !stamped) applyBrush(m_pointer.x, m_pointer.y, true, pigmentColor);
+}
+
+void Simulation::stampBrush(float normX, float normY, const glm::vec3& pigmentColor) {
+    ScopedTimer timer(profiler, ProfileStage::Brush);
+    m_brushMask.update(params.brushRadius, params.brushSoftness);
+    stamp(normX * m_grid.width, normY * m_grid.height, pigmentColor);
 }
 
 void Simulation::step(float dt) {
+    ScopedTimer timer(profiler, ProfileStage::Step);
+    syncExecutionParams();
+    updateActiveTiles();
+
+    // 젖은 타일이 없고 지난 증발 지시자도 지워졌으면 모든 커널이 아무것도 바꾸지 않음
+    m_settled = m_tiles.activeCount() == 0 && m_evapRect[0] == m_evapRect[2];
+    if (m_settled) {
+        m_stats = SimulationStats{};
+        return;
+    }
+    m_tiles.markActiveChanged();  // 이번 스텝 커널이 쓰는 셀은 모두 활성 타일 안
     updateVelocity(dt);
     updateWater(dt);
     updatePigment(dt);
-    updateSurfaceLayer(dt);
-    updateCapillaryLayer();
+    {
+        ScopedTimer t(profiler, ProfileStage::SurfaceLayer);
+        updateSurfaceLayer(dt);
+    }
+    {
+        ScopedTimer t(profiler, ProfileStage::CapillaryLayer);
+        updateCapillaryLayer();
+    }
 }
 
-void Simulation::updateRenderBuffer(DisplayMode mode) {
-    const int w = m_grid.width;
-    const int h = m_grid.height;
+float Simulation::nextStepDt() const {
+    if (params.timeStepping == TimeStepping::Fixed) return params.fixedDt;
 
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            const int idx    = m_grid.index(x, y);
-            const int rgbIdx = 3 * x + 3 * y * w;
-
-            float r = 0.0f, g = 0.0f, b = 0.0f;
-
-            // 사전 곱셈 합성: out = premulColor + (1 - 농도) × 종이색
-            switch (mode) {
-            case DisplayMode::Composite: {
-                float total = m_grid.pigmentDeposit[idx] + m_grid.pigment[idx];
-                glm::vec3 combined = m_grid.depositColor[idx] + m_grid.surfaceColor[idx];
-                float paper = m_grid.paper[rgbIdx];
-                r = combined.r + (1.0f - total) * paper;
-                g = combined.g + (1.0f - total) * paper;
-                b = combined.b + (1.0f - total) * paper;
-                break;
-            }
-            case DisplayMode::Water:
-                r = g = b = m_grid.water[idx];
-                break;
-            case DisplayMode::Saturation:
-                r = g = b = m_grid.saturation[idx];
-                break;
-            case DisplayMode::VelocityX:
-                r = g = b = m_grid.velocity[idx].x;
-                break;
-            case DisplayMode::WetMask:
-                r = g = b = m_grid.wetAreaMask[idx];
-                break;
-            case DisplayMode::Evaporation:
-                r = g = b = m_grid.evaporation[idx];
-                break;
-            case DisplayMode::Deposit: {
-                float paper = m_grid.paper[rgbIdx];
-                float d     = m_grid.pigmentDeposit[idx];
-                r = m_grid.depositColor[idx].r + (1.0f - d) * paper;
-                g = m_grid.depositColor[idx].g + (1.0f - d) * paper;
-                b = m_grid.depositColor[idx].b + (1.0f - d) * paper;
-                break;
-            }
-            case DisplayMode::SurfacePigment: {
-                float paper = m_grid.paper[rgbIdx];
-                float p     = m_grid.pigment[idx];
-                r = m_grid.surfaceColor[idx].r + (1.0f - p) * paper;
-                g = m_grid.surfaceColor[idx].g + (1.0f - p) * paper;
-                b = m_grid.surfaceColor[idx].b + (1.0f - p) * paper;
-                break;
-            }
-            }
+    // 최대 속도가 0이면 상한, 매우 빠르면 k_minStepDt 아래로는 내려가지 않음
+    // (그때는 maxSubsteps에 걸려 시뮬레이션이 벽시계보다 느려짐)
+    constexpr float k_minStepDt = 1e-4f;
+    const float speed = m_stats.maxVelocity * static_cast<float>(std::max(1, params.speedMultiplier));
+    const float dt    = speed > 0.0f ? params.cflTarget / speed : params.maxDt;
+    return std::min(params.maxDt, std::max(k_minStepDt, dt));
+}
 
-            m_grid.renderBuffer[rgbIdx + 0] = r;
-            m_grid.renderBuffer[rgbIdx + 1] = g;
-            m_grid.renderBuffer[rgbIdx + 2] = b;
-        }
+void Simulation::updateRenderBuffer(DisplayMode mode, const RenderRegion& region, float* out) {
+    ScopedTimer timer(profiler, ProfileStage::RenderBuffer);
+    syncExecutionParams();
+    const int w    = region.width();
+    const int h    = region.height();
+    const int step = region.step;
+
+    // 출력 텍셀 (i, j)는 자기 step × step 블록의 가운데 셀을 샘플링 (step = 1이면 셀 그대로).
+    // 캔버스 밖 텍셀은 가장 가까운 가장자리 셀 (화면 타일의 테두리 텍셀).
+    // 열 방향 클램프는 캔버스 안 열 구간 [iLo, iHi)로 미리 풀어 둔다
+    const int first = region.x0 + step / 2;
+    const int xMax  = m_grid.width - 1;
+    const int iLo   = std::clamp(first >= 0 ? 0 : (step - 1 - first) / step, 0, w);
+    const int iHi   = std::clamp(first > xMax ? 0 : (xMax - first) / step + 1, iLo, w);
+
+    const std::ptrdiff_t o = m_grid.index(0, 0);
+    CompositeArgs args;
+    args.pigment   = m_grid.pigment.data() + o;
+    args.deposit   = m_grid.pigmentDeposit.data() + o;
+    args.heightMap = m_grid.heightMap.data() + o;
+    for (int c = 0; c < 3; ++c) {
+        args.surfaceColor[c] = m_grid.surfaceColor.plane(c) + o;
+        args.depositColor[c] = m_grid.depositColor.plane(c) + o;
+    }
+    args.stride      = m_grid.stride;
+    args.paperRelief = Grid::k_paperRelief;
+
+    // 모드는 여기서 한 번만 분기하고 행 묶음은 풀에서 병렬로
+    auto run = [&](auto modeTag, const float* field) {
+        constexpr DisplayMode Mode = decltype(modeTag)::value;
+        m_pool.parallelFor(0, h, [&](int jBegin, int jEnd) {
+            renderRows<Mode>(m_grid, *m_kernels, args, field, region, iLo, iHi, jBegin, jEnd, out);
+        });
+    };
+    using M = DisplayMode;
+    switch (mode) {
+    case M::Composite:      run(std::integral_constant<M, M::Composite>{},      nullptr);                   break;
+    case M::Deposit:        run(std::integral_constant<M, M::Deposit>{},        nullptr);                   break;
+    case M::SurfacePigment: run(std::integral_constant<M, M::SurfacePigment>{}, nullptr);                   break;
+    case M::Water:          run(std::integral_constant<M, M::Water>{},          m_grid.water.data());       break;
+    case M::Saturation:     run(std::integral_constant<M, M::Saturation>{},     m_grid.saturation.data());  break;
+    case M::VelocityX:      run(std::integral_constant<M, M::VelocityX>{},      m_grid.velocity.plane(0));  break;
+    case M::WetMask:        run(std::integral_constant<M, M::WetMask>{},        m_grid.wetAreaMask.data()); break;
+    case M::Evaporation:    run(std::integral_constant<M, M::Evaporation>{},    m_grid.evaporation.data()); break;
     }
 }
 
-// --- 결합 업데이트 스텝 -------------------------------------------------------
+void Simulation::updateTileLayers(DisplayMode mode, const RenderRegion& region, float* tile,
+                                  int tx, int ty, bool withPaper) {
+    ScopedTimer timer(profiler, ProfileStage::RenderBuffer);
+    syncExecutionParams();
+    const TileLayout layout = TileLayout::of(mode);
+    const int        w      = region.width();
+    const int        h      = region.height();
+    const int        step   = region.step;
+
+    // 스칼라 모드가 보여 줄 필드
+    const float* scalar = nullptr;
+    switch (mode) {
+    case DisplayMode::Water:       scalar = m_grid.water.data();       break;
+    case DisplayMode::Saturation:  scalar = m_grid.saturation.data();  break;
+    case DisplayMode::VelocityX:   scalar = m_grid.velocity.plane(0);  break;
+    case DisplayMode::WetMask:     scalar = m_grid.wetAreaMask.data(); break;
+    case DisplayMode::Evaporation: scalar = m_grid.evaporation.data(); break;
+    default:                                                           break;
+    }
 
-void Simulation::updateVelocity(float dt) {
-    diffuse(params.velocityViscosity, m_grid.velocity.data(),
-            m_grid.wetAreaMask.data(), dt);
-    advect(m_grid.velocity.data(), m_grid.velocityTemp.data(),
-           m_grid.velocity.data(), dt);
-    addHeightDifferenceVelocity();
-    applyBoundaryConditions();
+    // 샘플링은 updateRenderBuffer와 같음 (블록 가운데 셀, 캔버스 밖은 가장자리 셀)
+    const int xMax = m_grid.width - 1;
+    const int yMax = m_grid.height - 1;
+    m_pool.parallelFor(0, h, [&](int jBegin, int jEnd) {
+        for (int j = jBegin; j < jEnd; ++j) {
+            const int    y   = std::clamp(region.y0 + j * step + step / 2, 0, yMax);
+            const size_t row = static_cast<size_t>(ty + j) * k_tileSide + tx;
+            for (int i = 0; i < w; ++i) {
+                const int            x   = std::clamp(region.x0 + i * step + step / 2, 0, xMax);
+                const std::ptrdiff_t idx = m_grid.index(x, y);
+                const size_t         t   = row + i;
+
+                if (withPaper && layout.has(TileLayer::Paper))
+                    tile[layout.at(TileLayer::Paper) + t] = m_grid.paperShade(idx);
+                if (layout.has(TileLayer::Surface)) {
+                    float* out = tile + layout.at(TileLayer::Surface) + 4 * t;
+                    for (int c = 0; c < 3; ++c) out[c] = m_grid.surfaceColor.plane(c)[idx];
+                    out[3] = m_grid.pigment[idx];
+                }
+                if (layout.has(TileLayer::Deposit)) {
+                    float* out = tile + layout.at(TileLayer::Deposit) + 4 * t;
+                    for (int c = 0; c < 3; ++c) out[c] = m_grid.depositColor.plane(c)[idx];
+                    out[3] = m_grid.pigmentDeposit[idx];
+                }
+                if (scalar) tile[layout.at(TileLayer::Scalar) + t] = scalar[idx];
+            }
+        }
+    });
 }
 
-void Simulation::updateWater(float dt) {
-    diffuse(params.waterViscosity, m_grid.water.data(),
-            m_grid.wetAreaMask.data(), dt);
-    waterAdvect(m_grid.water.data(), m_grid.waterTemp.data(),
-                m_grid.velocity.data(), m_grid.wetAreaMask.data(),
-                static_cast<float>(params.speedMultiplier) * dt);
-    flowOutward();
+void Simulation::refreshActiveTiles() {
+    m_settled = false;
+    m_tiles.markAll();
+    m_tiles.markAllChanged();
+    updateActiveTiles();
 }
 
-void Simulation::updatePigment(float dt) {
-    // 안료 농도와 색상을 함께 확산 (색 경계 유지)
-    diffuse(params.pigmentViscosity, m_grid.pigment.data(),
-            m_grid.wetAreaMask.data(), dt);
-    diffuse(params.pigmentViscosity, m_grid.surfaceColor.data(),
-            m_grid.wetAreaMask.data(), dt);
+bool Simulation::initCanvas() {
+    syncExecutionParams();
+    if (!m_grid.init(&m_pool)) return false;
+    m_evapRect = { 0, 0, 0, 0 };
+    refreshActiveTiles();
+    return true;
+}
 
-    waterAdvect(m_grid.pigment.data(), m_grid.pigmentTemp.data(),
-                m_grid.velocity.data(), m_grid.wetAreaMask.data(),
-                static_cast<float>(params.speedMultiplier) * dt);
-    advect(m_grid.surfaceColor.data(), m_grid.surfaceColorTemp.data(),
-           m_grid.velocity.data(),
-           static_cast<float>(params.speedMultiplier) * dt);
+void Simulation::resetCanvas() {
+    syncExecutionParams();
+    m_grid.reset(m_pool);
+    m_evapRect = { 0, 0, 0, 0 };  // evaporation도 0이 됨
+    refreshActiveTiles();
 }
 
-// --- 유체 솔버 ----------------------------------------------------------------
+void Simulation::updateActiveTiles() {
+    const std::ptrdiff_t o = m_grid.index(0, 0);
+    m_tiles.rebuild(m_grid.wetAreaMask.data() + o, m_grid.saturation.data() + o,
+                    m_grid.stride, params.capillaryThreshold);
+
+    // 비활성이 된 타일은 전부 건조 셀 → applyBoundaryConditions와 같이 속도 0.
+    // (flowOutward에서 마른 셀의 잔여 속도가 비활성 구간에 남지 않도록 함)
+    m_tiles.forEachDeactivated([&](int x0, int y0, int x1, int y1) {
+        m_tiles.markChanged(x0, y0, x1, y1);
+        for (int c = 0; c < 2; ++c) {
+            float* velocity = m_grid.velocity.plane(c);
+            for (int y = y0; y < y1; ++y)
+                std::fill_n(velocity + m_grid.index(x0, y), x1 - x0, 0.0f);
+        }
+    });
+}
 
-template<typename T>
-T Simulation::sampleBilinear(const T* field, const glm::vec2& pos) const {
-    const float wx = static_cast<float>(m_grid.width  - 1) - 1e-6f;
-    const float wy = static_cast<float>(m_grid.height - 1) - 1e-6f;
-    glm::vec2 p = glm::max(glm::vec2(0.0f), glm::min(glm::vec2(wx, wy), pos));
+template<int N>
+void Simulation::copyActive(PlaneSet<N> src, PlaneSet<N> dst) {
+    const int w = m_grid.width;
+    const int h = m_grid.height;
+    parallelRows(0, h, 0, w, [&](int y, int x0, int x1) {
+        const std::ptrdiff_t c = m_grid.index(x0, y);
+        for (int p = 0; p < N; ++p) std::copy_n(src[p] + c, x1 - x0, dst[p] + c);
+    });
+}
 
-    const int   x = static_cast<int>(std::floor(p.x));
-    const int   y = static_cast<int>(std::floor(p.y));
-    const float s = p.x - static_cast<float>(x);
-    const float t = p.y - static_cast<float>(y);
+template<int N>
+void Simulation::copyInactive(PlaneSet<N> src, PlaneSet<N> dst) {
+    const int            w    = m_grid.width;
+    const int            h    = m_grid.height;
+    const std::ptrdiff_t s    = m_grid.stride;
+    const int            rows = h + 2 * m_grid.halo;
+    m_pool.parallelFor(0, rows, [&](int rowBegin, int rowEnd) {
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            // 행 r에서 활성 구간 사이의 틈 [from, to)를 복사 (구간은 왼쪽부터 순회)
+            std::ptrdiff_t from = r * s;
+            auto gap = [&](std::ptrdiff_t to) {
+                for (int p = 0; p < N; ++p) std::copy(src[p] + from, src[p] + to, dst[p] + from);
+            };
+            const int y = r - m_grid.halo;
+            if (y >= 0 && y < h) {
+                m_tiles.forEachRow(y, y + 1, 0, w, [&](int, int x0, int x1) {
+                    gap(m_grid.index(x0, y));
+                    from = m_grid.index(x1, y);
+                });
+            }
+            gap((r + 1) * s);
+        }
+    });
+}
 
-    T v0 = field[m_grid.index(x,     y)] * (1.0f - s)
-         + field[m_grid.index(x + 1, y)] * s;
-    T v1 = field[m_grid.index(x,     y + 1)] * (1.0f - s)
-         + field[m_grid.index(x + 1, y + 1)] * s;
-    return v0 * (1.0f - t) + v1 * t;
+bool Simulation::swapPays() const {
+    const size_t activeCells = static_cast<size_t>(m_tiles.activeCount())
+                             * ActiveTiles::k_tileSize * ActiveTiles::k_tileSize;
+    return 2 * activeCells >= m_grid.cellCount();
 }
 
 template<typename T>
-void Simulation::advect(T* field, T* tempBuffer,
-                         const glm::vec2* vel, float dt) {
-    const int w = m_grid.width;
-    const int h = m_grid.height;
+void Simulation::commitScratch(Scratch<T>& out, T& field) {
+    constexpr int N = T::k_planes;
+    PlaneSet<N> written, previous;
+    for (int p = 0; p < N; ++p) {
+        written[p]  = componentOf(*out, p).data();
+        previous[p] = componentOf(field, p).data();
+    }
+    if (swapPays()) {
+        out.swapInto(field);
+        copyInactive<N>(previous, written);
+    } else {
+        copyActive<N>(written, previous);
+    }
+}
 
-    // 각 셀을 역추적해 출발점에서 샘플링
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            glm::vec2 departure = glm::vec2(static_cast<float>(x),
-                                            static_cast<float>(y))
-                                  - dt * vel[m_grid.index(x, y)];
-            tempBuffer[m_grid.index(x, y)] = sampleBilinear(field, departure);
-        }
+// --- 결합 업데이트 스텝 -------------------------------------------------------
+
+void Simulation::updateVelocity(float dt) {
+    Vec2Field& velocity = m_grid.velocity;
+    {
+        ScopedTimer t(profiler, ProfileStage::DiffuseVelocity);
+        Scratch<Vec2Field> rhs(m_scratch);
+        diffuse<2>(params.velocityViscosity, velocity.planes(), rhs->planes(),
+                   m_grid.wetAreaMask.data(), dt, DiffuseField::Velocity);
+    }
+    {
+        ScopedTimer t(profiler, ProfileStage::AdvectVelocity);
+        Scratch<Vec2Field> advected(m_scratch);
+        advect<2>(velocity.planes(), advected->planes(),
+                  velocity.plane(0), velocity.plane(1), dt);
+        commitScratch(advected, velocity);
+    }
+    {
+        ScopedTimer t(profiler, ProfileStage::HeightVelocity);
+        addHeightDifferenceVelocity();
+    }
+    {
+        ScopedTimer t(profiler, ProfileStage::BoundaryConditions);
+        applyBoundaryConditions();
     }
-    for (int i = 0; i < w * h; ++i) field[i] = tempBuffer[i];
 }
 
-template<typename T>
-void Simulation::diffuse(float k, T* field, const float* mask, float dt) {
-    const int w = m_grid.width;
-    const int h = m_grid.height;
+void Simulation::updateWater(float dt) {
+    FloatPlane& water = m_grid.water;
+    {
+        ScopedTimer t(profiler, ProfileStage::DiffuseWater);
+        Scratch<FloatPlane> rhs(m_scratch);
+        diffuse<1>(params.waterViscosity, planesOf(water), planesOf(*rhs),
+                   m_grid.wetAreaMask.data(), dt, DiffuseField::Water);
+    }
+    {
+        ScopedTimer t(profiler, ProfileStage::AdvectWater);
+        Scratch<FloatPlane> advected(m_scratch);
+        waterAdvect(water.data(), advected->data(),
+                    m_grid.velocity.plane(0), m_grid.velocity.plane(1),
+                    m_grid.wetAreaMask.data(), static_cast<float>(params.speedMultiplier) * dt);
+        commitScratch(advected, water);
+    }
+    {
+        ScopedTimer t(profiler, ProfileStage::FlowOutward);
+        flowOutward();
+    }
+}
 
-    // 가우스-자이델 10회 반복 (k*dt가 작을 때 충분히 수렴)
-    for (int iter = 0; iter < 10; ++iter) {
-        for (int y = 1; y < h - 1; ++y) {
-            for (int x = 1; x < w - 1; ++x) {
-                if (!mask[m_grid.index(x, y)]) continue;
-                // 암묵적 스킴: D_new = (D + k*dt * 이웃합) / (1 + 4*k*dt)
-                field[m_grid.index(x, y)] =
-                    (field[m_grid.index(x, y)]
-                     + k * dt * (field[m_grid.index(x - 1, y)]
-                                + field[m_grid.index(x + 1, y)]
-                                + field[m_grid.index(x, y - 1)]
-                                + field[m_grid.index(x, y + 1)]))
-                    / (1.0f + 4.0f * k * dt);
-            }
-        }
+void Simulation::updatePigment(float dt) {
+    // 안료 농도와 사전 곱셈 색상을 4성분 한 시스템으로 확산: 같은 반복 횟수가 적용되므로
+    // 색/농도 비가 유지되고, 마스크/색 판정을 셀당 한 번만 함 (색 경계 유지)
+    {
+        ScopedTimer t(profiler, ProfileStage::DiffusePigment);
+        Scratch<FloatPlane> rhsPigment(m_scratch);
+        Scratch<Vec3Field>  rhsColor(m_scratch);
+        Vec3Field&          color = m_grid.surfaceColor;
+        const PlaneSet<4>   field = { m_grid.pigment.data(),
+                                      color.plane(0), color.plane(1), color.plane(2) };
+        const PlaneSet<4>   rhs   = { rhsPigment->data(),
+                                      rhsColor->plane(0), rhsColor->plane(1), rhsColor->plane(2) };
+        diffuse<4>(params.pigmentViscosity, field, rhs, m_grid.wetAreaMask.data(), dt,
+                   DiffuseField::Pigment);
+    }
+    {
+        ScopedTimer t(profiler, ProfileStage::AdvectPigment);
+        advectPigment(m_grid.velocity.plane(0), m_grid.velocity.plane(1),
+                      m_grid.wetAreaMask.data(), static_cast<float>(params.speedMultiplier) * dt);
     }
 }
 
-template<typename T>
-void Simulation::waterAdvect(T* field, T* tempBuffer,
-                              const glm::vec2* vel, const float* mask,
-                              float dt) {
+// --- 유체 솔버 ----------------------------------------------------------------
+
+template<int N>
+void Simulation::advect(PlaneSet<N> src, PlaneSet<N> dst,
+                        const float* velU, const float* velV, float dt) {
     const int w = m_grid.width;
     const int h = m_grid.height;
+    const std::ptrdiff_t o = m_grid.index(0, 0);
 
-    for (int i = 0; i < w * h; ++i) tempBuffer[i] = field[i];
-
-    for (int y = 1; y < h - 1; ++y) {
-        for (int x = 1; x < w - 1; ++x) {
-            const int c  = m_grid.index(x,     y);
-            const int xp = m_grid.index(x + 1, y);
-            const int xm = m_grid.index(x - 1, y);
-            const int yp = m_grid.index(x,     y + 1);
-            const int ym = m_grid.index(x,     y - 1);
-
-            // 면 중심 속도: 인접 셀 평균, 건조 경계는 0으로 차단
-            float vx1 = mask[c] * mask[xp] * (vel[c].x + vel[xp].x) * 0.5f;
-            float vx2 = mask[c] * mask[xm] * (vel[c].x + vel[xm].x) * 0.5f;
-            float vy1 = mask[c] * mask[yp] * (vel[c].y + vel[yp].y) * 0.5f;
-            float vy2 = mask[c] * mask[ym] * (vel[c].y + vel[ym].y) * 0.5f;
-
-            float flux = 0.0f;
-
-            // +x 면
-            if (vx1 > 0.0f) {
-                flux = vx1 * dt * field[c] / 4.0f;
-                tempBuffer[c] -= std::min(std::abs(k_maxWater - field[xp]),
-                                          std::min(std::abs(flux), std::abs(k_minWater - field[c])));
-            } else {
-                flux = vx1 * dt * field[xp] / 4.0f;
-                tempBuffer[c] += std::min(std::abs(k_maxWater - field[c]),
-                                          std::min(std::abs(flux), std::abs(k_minWater - field[xm])));
-            }
+    // 쌍선형 샘플링의 +1 이웃이 격자 밖(유령 셀)을 읽으므로 먼저 테두리를 채움
+    for (int c = 0; c < N; ++c) m_grid.fillBorder(src[c]);
 
-            // -x 면
-            if (vx2 > 0.0f) {
-                flux = vx2 * dt * field[xm] / 4.0f;
-                tempBuffer[c] += std::min(std::abs(k_maxWater - field[c]),
-                                          std::min(std::abs(flux), std::abs(k_minWater - field[xm])));
-            } else {
-                flux = vx2 * dt * field[c] / 4.0f;
-                tempBuffer[c] -= std::min(std::abs(k_maxWater - field[xm]),
-                                          std::min(std::abs(flux), std::abs(k_minWater - field[c])));
-            }
+    AdvectArgs args{};
+    for (int c = 0; c < N; ++c) {
+        args.src[c] = src[c] + o;
+        args.dst[c] = dst[c] + o;
+    }
+    args.planes = N;
+    args.velU   = velU + o;
+    args.velV   = velV + o;
+    args.width  = w;
+    args.height = h;
+    args.stride = m_grid.stride;
+    args.dt     = dt;
+
+    // 각 셀을 역추적해 출발점에서 샘플링 (비활성 타일은 속도 0 → 항등)
+    parallelRows(0, h, 0, w, [&](int y, int x0, int x1) {
+        m_kernels->advectRow(args, y, x0, x1);
+    });
+}
 
-            // +y 면
-            if (vy1 > 0.0f) {
-                flux = vy1 * dt * field[c] / 4.0f;
-                tempBuffer[c] -= std::min(std::abs(k_maxWater - field[c]),
-                                          std::min(std::abs(flux), std::abs(k_minWater - field[ym])));
-            } else {
-                flux = vy1 * dt * field[yp] / 4.0f;
-                tempBuffer[c] += std::min(std::abs(k_maxWater - field[ym]),
-                                          std::min(std::abs(flux), std::abs(k_minWater - field[c])));
+template<int N>
+void Simulation::diffuse(float k, PlaneSet<N> field, PlaneSet<N> rhs, const float* mask, float dt,
+                         DiffuseField which) {
+    const int   w    = m_grid.width;
+    const int   h    = m_grid.height;
+    const int   s    = m_grid.stride;
+    const float a    = k * dt;
+    const float diag = 1.0f + 4.0f * a;
+    const int   slot = static_cast<int>(which);
+
+    m_stats.diffuseIterations[slot] = 0;
+    m_stats.diffuseResidual[slot]   = 0.0f;
+    if (a <= 0.0f) return;
+
+    // 우변 b = 확산 전 필드. 잔차 척도는 활성 구간의 max|b| (건조 이웃은 고정 경계값)
+    std::atomic<float> scale{ 0.0f };
+    parallelRows(0, h, 0, w, [&](int y, int x0, int x1) {
+        float                local = 0.0f;
+        const std::ptrdiff_t row   = m_grid.index(0, y);
+        for (int c = 0; c < N; ++c) {
+            for (int x = x0; x < x1; ++x) {
+                rhs[c][row + x] = field[c][row + x];
+                local = std::max(local, std::abs(field[c][row + x]));
             }
-
-            // -y 면
-            if (vy2 > 0.0f) {
-                flux = vy2 * dt * field[ym] / 4.0f;
-                tempBuffer[c] += std::min(std::abs(k_maxWater - field[yp]),
-                                          std::min(std::abs(flux), std::abs(k_minWater - field[c])));
-            } else {
-                flux = vy2 * dt * field[c] / 4.0f;
-                tempBuffer[c] -= std::min(std::abs(k_maxWater - field[c]),
-                                          std::min(std::abs(flux), std::abs(k_minWater - field[yp])));
+        }
+        atomicMax(scale, local);
+    });
+    const float bScale = scale.load();
+    if (bScale == 0.0f) return;  // 모두 0 → 해도 0
+
+    const float threshold = params.diffusionTolerance * bScale;
+    const int   maxIter   = std::max(1, params.diffusionMaxIter);
+    float residual = 0.0f;
+    int   iter     = 0;
+
+    if (params.diffusionSolver == DiffusionSolver::Multigrid) {
+        // 젖은 셀은 모두 활성 경계 상자 안 → 상자(격자 테두리 제외)에서만 풀이
+        int x0, y0, x1, y1;
+        if (m_tiles.bounds(x0, y0, x1, y1)) {
+            x0 = std::max(x0, 1);  x1 = std::min(x1, w - 1);
+            y0 = std::max(y0, 1);  y1 = std::min(y1, h - 1);
+            const std::ptrdiff_t o = m_grid.index(0, 0);
+            PlaneSet<N>          u;
+            ConstPlaneSet<N>     b;
+            for (int c = 0; c < N; ++c) {
+                u[c] = field[c] + o;
+                b[c] = rhs[c] + o;
             }
+            iter = std::get<Multigrid<N>>(m_multigrid).solve(
+                u, b, mask + o, s, x0, y0, x1, y1, a, threshold, maxIter,
+                *m_kernels, m_pool, residual);
         }
+        m_stats.diffuseIterations[slot] = iter;
+        m_stats.diffuseResidual[slot]   = residual / bScale;
+        return;
     }
 
-    for (int i = 0; i < w * h; ++i) field[i] = tempBuffer[i];
+    // 한 색의 셀만 갱신 (x + y) % 2 == colour. 같은 색 셀끼리는 서로 읽지 않으므로
+    // 행 묶음을 병렬로 처리해도 결과가 스레드 수와 무관.
+    // 반환값 = 갱신 전 잔차 max|b - A·D| (= diag × 최대 변화량)
+    auto sweep = [&](int colour) {
+        std::atomic<float> change{ 0.0f };
+        parallelRows(1, h - 1, 1, w - 1, [&](int y, int x0, int x1) {
+            const std::ptrdiff_t row = m_grid.index(0, y);
+            float*               u[N];
+            const float*         b[N];
+            for (int c = 0; c < N; ++c) {
+                u[c] = field[c] + row;
+                b[c] = rhs[c] + row;
+            }
+            atomicMax(change, m_kernels->diffuseRow(u, b, N, mask + row, s,
+                                                    x0, x1, (y + colour) & 1, a, diag));
+        });
+        return diag * change.load();
+    };
+
+    while (iter < maxIter) {
+        ++iter;
+        const float red   = sweep(0);
+        const float black = sweep(1);
+        residual = std::max(red, black);
+        if (residual <= threshold) break;
+    }
+
+    m_stats.diffuseIterations[slot] = iter;
+    m_stats.diffuseResidual[slot]   = residual / bScale;
 }
 
-// --- 시뮬레이션 서브스텝 ------------------------------------------------------
+WaterFluxArgs Simulation::waterFluxArgs(const float* field, float* out,
+                                        const float* velU, const float* velV,
+                                        const float* mask, float dt) const {
+    const std::ptrdiff_t o = m_grid.index(0, 0);
+    WaterFluxArgs args{};
+    args.field    = field + o;
+    args.out      = out + o;
+    args.velU     = velU + o;
+    args.velV     = velV + o;
+    args.mask     = mask + o;
+    args.stride   = m_grid.stride;
+    args.dt       = dt;
+    args.maxValue = k_maxWater;
+    args.minValue = k_minWater;
+    return args;
+}
 
-// 수위 기울기로 속도 갱신 (물이 낮은 쪽으로 흐름)
-void Simulation::addHeightDifferenceVelocity() {
+void Simulation::copyEdgeCells(const float* src, float* dst, int y, int x0, int x1) const {
+    const std::ptrdiff_t c0 = m_grid.index(x0, y);
+    if (y == 0 || y == m_grid.height - 1) {
+        std::copy(src + c0, src + c0 + (x1 - x0), dst + c0);
+        return;
+    }
+    if (x0 == 0)             dst[c0] = src[c0];
+    if (x1 == m_grid.width)  dst[c0 + (x1 - x0) - 1] = src[c0 + (x1 - x0) - 1];
+}
+
+void Simulation::waterAdvect(const float* field, float* out,
+                             const float* velU, const float* velV, const float* mask,
+                             float dt) {
     const int w = m_grid.width;
     const int h = m_grid.height;
 
-    for (int y = 1; y < h - 1; ++y) {
-        for (int x = 1; x < w - 1; ++x) {
-            const int c  = m_grid.index(x, y);
-            glm::vec2 grad;
-            grad.x = (m_grid.water[m_grid.index(x - 1, y)]
-                     - m_grid.water[m_grid.index(x + 1, y)]) * 0.5f;
-            grad.y = (m_grid.water[m_grid.index(x, y - 1)]
-                     - m_grid.water[m_grid.index(x, y + 1)]) * 0.5f;
-            // 이전 속도 90% + 수위 기반 성분 10%
-            m_grid.velocity[c] = 0.9f * m_grid.velocity[c] + 0.1f * grad;
-        }
+    // 건조 셀은 면 속도가 모두 0이므로 변화 없음 → 활성 구간만 처리.
+    // 내부 셀은 커널이 field + 플럭스를 out에 쓰고, 가장자리 셀은 값 그대로 옮김
+    const WaterFluxArgs args = waterFluxArgs(field, out, velU, velV, mask, dt);
+    parallelRows(0, h, 0, w, [&](int y, int x0, int x1) {
+        copyEdgeCells(field, out, y, x0, x1);
+        if (y < 1 || y >= h - 1) return;
+        const int fx0 = std::max(x0, 1);
+        const int fx1 = std::min(x1, w - 1);
+        if (fx0 < fx1) m_kernels->waterFluxRow(args, y, fx0, fx1);
+    });
+}
+
+void Simulation::advectPigment(const float* velU, const float* velV, const float* mask,
+                               float dt) {
+    const int            w       = m_grid.width;
+    const int            h       = m_grid.height;
+    const std::ptrdiff_t o       = m_grid.index(0, 0);
+    float* const         pigment = m_grid.pigment.data();
+    Vec3Field&           color   = m_grid.surfaceColor;
+
+    Scratch<FloatPlane> pigmentOut(m_scratch);
+    Scratch<Vec3Field>  colorOut(m_scratch);
+    float* const        out = pigmentOut->data();
+
+    // 색상 쌍선형 샘플링의 +1 이웃이 유령 셀을 읽으므로 먼저 테두리를 채움
+    for (int c = 0; c < 3; ++c) m_grid.fillBorder(color.plane(c));
+
+    AdvectArgs args{};
+    for (int c = 0; c < 3; ++c) {
+        args.src[c] = color.plane(c) + o;
+        args.dst[c] = colorOut->plane(c) + o;
     }
+    args.planes = 3;
+    args.velU   = velU + o;
+    args.velV   = velV + o;
+    args.width  = w;
+    args.height = h;
+    args.stride = m_grid.stride;
+    args.dt     = dt;
+    const WaterFluxArgs flux = waterFluxArgs(pigment, out, velU, velV, mask, dt);
+
+    // 한 행에서: 색상 역추적 샘플링 → 농도 면 플럭스 (가장자리 셀은 그대로 옮김).
+    // 두 단계가 같은 속도/마스크 행을 캐시에 올린 채로 사용 (셀은 자기 자신만 기록)
+    parallelRows(0, h, 0, w, [&](int y, int x0, int x1) {
+        m_kernels->advectRow(args, y, x0, x1);
+
+        copyEdgeCells(pigment, out, y, x0, x1);
+        // 면 플럭스는 격자 내부 셀만 (waterAdvect와 같은 구간)
+        if (y < 1 || y >= h - 1) return;
+        const int fx0 = std::max(x0, 1);
+        const int fx1 = std::min(x1, w - 1);
+        if (fx0 < fx1) m_kernels->waterFluxRow(flux, y, fx0, fx1);
+    });
+
+    // 모든 읽기가 끝난 뒤 4개 평면을 반영
+    commitScratch(pigmentOut, m_grid.pigment);
+    commitScratch(colorOut, color);
+}
+
+// --- 시뮬레이션 서브스텝 ------------------------------------------------------
+
+// 수위 기울기로 속도 갱신 (물이 낮은 쪽으로 흐름)
+void Simulation::addHeightDifferenceVelocity() {
+    const int    w     = m_grid.width;
+    const int    h     = m_grid.height;
+    const int    s     = m_grid.stride;
+    const float* water = m_grid.water.data();
+    float*       velU  = m_grid.velocity.plane(0);
+    float*       velV  = m_grid.velocity.plane(1);
+
+    // 적응 스텝용 최대 속도 제곱 (행 묶음별 최댓값을 합침)
+    std::atomic<float> maxSpeed2{ 0.0f };
+    m_pool.parallelFor(1, h - 1, [&](int yBegin, int yEnd) {
+        float local = 0.0f;
+        m_tiles.forEachRow(yBegin, yEnd, 1, w - 1, [&](int y, int x0, int x1) {
+            for (std::ptrdiff_t c = m_grid.index(x0, y), end = c + (x1 - x0); c < end; ++c) {
+                const float gradX = (water[c - 1] - water[c + 1]) * 0.5f;
+                const float gradY = (water[c - s] - water[c + s]) * 0.5f;
+                // 이전 속도 90% + 수위 기반 성분 10%
+                const float u = 0.9f * velU[c] + 0.1f * gradX;
+                const float v = 0.9f * velV[c] + 0.1f * gradY;
+                velU[c] = u;
+                velV[c] = v;
+                local   = std::max(local, u * u + v * v);
+            }
+        });
+        atomicMax(maxSpeed2, local);
+    });
+    m_stats.maxVelocity = std::sqrt(maxSpeed2.load());
 }
 
 // 건조 셀 속도 = 0 (no-slip 경계 조건)
 void Simulation::applyBoundaryConditions() {
-    const int w = m_grid.width;
-    const int h = m_grid.height;
-
-    for (int y = 1; y < h - 1; ++y) {
-        for (int x = 1; x < w - 1; ++x) {
-            if (!m_grid.wetAreaMask[m_grid.index(x, y)])
-                m_grid.velocity[m_grid.index(x, y)] = glm::vec2(0.0f);
+    const int    w    = m_grid.width;
+    const int    h    = m_grid.height;
+    const float* mask = m_grid.wetAreaMask.data();
+    float*       velU = m_grid.velocity.plane(0);
+    float*       velV = m_grid.velocity.plane(1);
+
+    parallelRows(1, h - 1, 1, w - 1, [&](int y, int x0, int x1) {
+        const std::ptrdiff_t row = m_grid.index(0, y);
+        for (std::ptrdiff_t c = row + x0; c < row + x1; ++c) {
+            if (!mask[c]) {
+                velU[c] = 0.0f;
+                velV[c] = 0.0f;
+            }
         }
-    }
+    });
 }
 
 // 경계 증발 처리: 가장자리 셀이 더 빨리 건조되어 외향 모세관류 발생
@@ -323,153 +785,176 @@ void Simulation::flowOutward() {
     const int   w          = m_grid.width;
     const int   h          = m_grid.height;
 
-    for (int i = 0; i < w * h; ++i)
-        m_grid.wetAreaMaskTemp[i] = m_grid.wetAreaMask[i];
-
-    // 젖은 마스크를 블러 → 경계에서 0, 내부에서 1인 부드러운 지시자
-    float* blurIn  = m_grid.wetAreaMaskTemp.data();
-    float* blurOut = m_grid.evaporation.data();
-    fastGaussianBlur(blurIn, blurOut, w, h, static_cast<float>(blurRadius));
+    // 건조 영역의 블러 결과는 0 → 지난번 블러 영역을 지우고 활성 영역만 다시 블러
+    for (int y = m_evapRect[1]; y < m_evapRect[3]; ++y)
+        std::fill_n(m_grid.evaporation.begin() + m_grid.index(m_evapRect[0], y),
+                    m_evapRect[2] - m_evapRect[0], 0.0f);
+    m_tiles.markChanged(m_evapRect[0], m_evapRect[1], m_evapRect[2], m_evapRect[3]);
+    m_evapRect = { 0, 0, 0, 0 };
+
+    int x0, y0, x1, y1;
+    if (m_tiles.bounds(x0, y0, x1, y1)) {
+        // 블러 지지 영역(3패스 박스 합)보다 넓은 여백을 두어 경계 처리가 결과에 닿지 않게 함
+        const int margin = 4 * blurRadius;
+        x0 = std::max(0, x0 - margin);  x1 = std::min(w, x1 + margin);
+        y0 = std::max(0, y0 - margin);  y1 = std::min(h, y1 + margin);
+        const int rw = x1 - x0;
+        const int rh = y1 - y0;
+
+        // 젖은 마스크를 블러 → 경계에서 0, 내부에서 1인 부드러운 지시자.
+        // 사각형은 패딩 없이 rw × rh로 임시 평면 앞부분에 담음 (rw × rh <= cellCount)
+        Scratch<FloatPlane> blurInPlane(m_scratch);
+        Scratch<FloatPlane> blurOutPlane(m_scratch);
+        float* blurIn  = blurInPlane->data();
+        float* blurOut = blurOutPlane->data();
+        for (int y = y0; y < y1; ++y)
+            std::copy_n(m_grid.wetAreaMask.begin() + m_grid.index(x0, y), rw,
+                        blurIn + (y - y0) * rw);
+        fastGaussianBlur(blurIn, blurOut, rw, rh, static_cast<float>(blurRadius));
+        // 전체 격자 블러 시절과 같이 출력으로 넘긴 평면의 내용을 지시자로 사용
+        const float* evap = blurOutPlane->data();
+        for (int y = y0; y < y1; ++y)
+            std::copy_n(evap + (y - y0) * rw, rw,
+                        m_grid.evaporation.begin() + m_grid.index(x0, y));
+        m_evapRect = { x0, y0, x1, y1 };
+        m_tiles.markChanged(x0, y0, x1, y1);
+    }
 
-    for (int y = 1; y < h - 1; ++y) {
-        for (int x = 1; x < w - 1; ++x) {
-            const int c = m_grid.index(x, y);
+    FloatPlane& water      = m_grid.water;
+    FloatPlane& saturation = m_grid.saturation;
+    parallelRows(1, h - 1, 1, w - 1, [&](int y, int x0, int x1) {
+        for (std::ptrdiff_t c = m_grid.index(x0, y), end = c + (x1 - x0); c < end; ++c) {
             // 경계(evaporation≈0)일수록 물 손실이 큼 → 안료가 가장자리로 집중
             float loss = evapRate * (1.0f - m_grid.evaporation[c]) * m_grid.wetAreaMask[c];
-            m_grid.water[c] -= loss;
-            if (m_grid.water[c] < 0.0f) m_grid.water[c] = 0.0f;
+            water[c] -= loss;
+            if (water[c] < 0.0f) water[c] = 0.0f;
 
             // 물이 없는 젖은 셀은 포화도를 서서히 감소
-            if (m_grid.water[c] == 0.0f && m_grid.wetAreaMask[c])
-                m_grid.saturation[c] -= 0.01f;
+            if (water[c] == 0.0f && m_grid.wetAreaMask[c])
+                saturation[c] -= 0.01f;
 
             // 포화도가 임계값 이하이면 건조 처리
-            if (m_grid.saturation[c] < params.wetMaskThreshold)
+            if (saturation[c] < params.wetMaskThreshold)
                 m_grid.wetAreaMask[c] = 0.0f;
         }
-    }
+    });
 }
 
-// 안료 흡착(수면→종이) / 탈착(종이→수면) 교환
+// 안료 흡착(수면→종이) / 탈착(종이→수면) 교환 (SimdKernels::surfaceLayerRow)
 void Simulation::updateSurfaceLayer(float dt) {
     const int w = m_grid.width;
     const int h = m_grid.height;
-
-    for (int y = 1; y < h - 1; ++y) {
-        for (int x = 1; x < w - 1; ++x) {
-            const int c = m_grid.index(x, y);
-            if (!m_grid.wetAreaMask[c]) continue;
-
-            // 경계 강화 인자 (edge darkening, Van Laerhoven §3.3):
-            // 경계(evaporation≈0)에서 흡착이 강해져 특유의 어두운 테두리 생성
-            float boundaryFactor = 1.0f
-                + std::max(0.0f, 1.0f - m_grid.evaporation[c]) * 3.0f;
-
-            // 흡착: 종이 골(높이 낮음)에 더 많이 침착
-            float adsorb = m_grid.pigment[c]
-                           * (1.0f - m_grid.heightMap[c] * params.granulation)
-                           * params.density
-                           * boundaryFactor;
-
-            // 탈착: 종이 봉우리(높이 높음)에서 재용출, 착색력으로 억제
-            float desorb = m_grid.pigmentDeposit[c]
-                           * (1.0f - (1.0f - m_grid.heightMap[c]) * params.granulation)
-                           * params.density / params.staining;
-
-            // 각 레이어가 1.0을 초과하지 않도록 클램프
-            if (m_grid.pigmentDeposit[c] + adsorb > 1.0f)
-                adsorb = std::max(0.0f, 1.0f - m_grid.pigmentDeposit[c]);
-            if (m_grid.pigment[c] + desorb > 1.0f)
-                desorb = std::max(0.0f, 1.0f - m_grid.pigment[c]);
-
-            // 사전 곱셈 색상 이전: 농도 비율만큼 색상도 비례 이동
-            if (adsorb > 0.0f && m_grid.pigment[c] > 0.001f) {
-                float ratio = adsorb / m_grid.pigment[c];
-                glm::vec3 transfer = m_grid.surfaceColor[c] * ratio;
-                m_grid.depositColor[c] += transfer;
-                m_grid.surfaceColor[c] -= transfer;
-            }
-            if (desorb > 0.0f && m_grid.pigmentDeposit[c] > 0.001f) {
-                float ratio = desorb / m_grid.pigmentDeposit[c];
-                glm::vec3 transfer = m_grid.depositColor[c] * ratio;
-                m_grid.surfaceColor[c] += transfer;
-                m_grid.depositColor[c] -= transfer;
-            }
-
-            m_grid.pigmentDeposit[c] += adsorb - desorb;
-            m_grid.pigment[c]        += desorb - adsorb;
-        }
+    const std::ptrdiff_t o = m_grid.index(0, 0);
+
+    SurfaceLayerArgs args{};
+    args.pigment     = m_grid.pigment.data() + o;
+    args.deposit     = m_grid.pigmentDeposit.data() + o;
+    args.heightMap   = m_grid.heightMap.data() + o;
+    args.evaporation = m_grid.evaporation.data() + o;
+    args.wetAreaMask = m_grid.wetAreaMask.data() + o;
+    for (int c = 0; c < 3; ++c) {
+        args.surfaceColor[c] = m_grid.surfaceColor.plane(c) + o;
+        args.depositColor[c] = m_grid.depositColor.plane(c) + o;
     }
+    args.stride      = m_grid.stride;
+    args.granulation = params.granulation;
+    args.density     = params.density;
+    args.staining    = params.staining;
+
+    parallelRows(1, h - 1, 1, w - 1, [&](int y, int x0, int x1) {
+        m_kernels->surfaceLayerRow(args, y, x0, x1);
+    });
 }
 
 // 모세관층: 표면물 흡수 → 포화도 확산 → 젖은 마스크 갱신
 void Simulation::updateCapillaryLayer() {
-    const int   w     = m_grid.width;
-    const int   h     = m_grid.height;
-    const float sigma = params.wetMaskThreshold;
-    const float eps   = params.capillaryThreshold;
+    const int         w          = m_grid.width;
+    const int         h          = m_grid.height;
+    const int         s          = m_grid.stride;
+    const float       sigma      = params.wetMaskThreshold;
+    const float       eps        = params.capillaryThreshold;
+    const FloatPlane& capacity   = m_grid.capacity;
+    FloatPlane&       water      = m_grid.water;
+    FloatPlane&       saturation = m_grid.saturation;
+
+    // 확산 결과 (모든 셀을 모은 뒤 saturation에 반영)
+    Scratch<FloatPlane> diffused(m_scratch);
 
     // 표면물을 모세관층으로 흡수 (남은 용량 한도 내)
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            const int c = m_grid.index(x, y);
+    m_tiles.forEachRow(0, h, 0, w, [&](int y, int x0, int x1) {
+        for (std::ptrdiff_t c = m_grid.index(x0, y), end = c + (x1 - x0); c < end; ++c) {
             if (!m_grid.wetAreaMask[c]) continue;
 
             float absorbed = std::max(0.0f,
-                std::min(params.absorption,
-                         m_grid.capacity[c] - m_grid.saturation[c]));
-            absorbed = std::min(absorbed, m_grid.water[c]);
+                std::min(params.absorption, capacity[c] - saturation[c]));
+            absorbed = std::min(absorbed, water[c]);
 
-            m_grid.saturation[c] += absorbed;
-            m_grid.water[c]      -= absorbed;
+            saturation[c] += absorbed;
+            water[c]      -= absorbed;
         }
-    }
-
-    // 동시 업데이트를 위해 임시 버퍼로 복사
-    for (int i = 0; i < w * h; ++i)
-        m_grid.saturationTemp[i] = m_grid.saturation[i];
-
-    // 포화도가 임계값 초과인 셀에서 이웃으로 확산
-    for (int y = 1; y < h - 1; ++y) {
-        for (int x = 1; x < w - 1; ++x) {
-            const int c = m_grid.index(x, y);
-            if (m_grid.saturation[c] <= eps) continue;
-
-            auto flowTo = [&](int neighbour) {
-                if (m_grid.saturation[c] <= m_grid.saturation[neighbour]) return;
-                float delta = std::max(0.0f,
-                    std::min(m_grid.saturation[c] - m_grid.saturation[neighbour],
-                             m_grid.capacity[neighbour] - m_grid.saturation[neighbour])
-                    / 4.0f);
-                m_grid.saturationTemp[c]         -= delta;
-                m_grid.saturationTemp[neighbour] += delta;
-            };
+    });
+
+    // 포화도가 임계값 초과인 격자 내부 셀 → 더 낮은 이웃으로 확산한 양
+    auto transfer = [&](std::ptrdiff_t from, std::ptrdiff_t to) {
+        if (saturation[from] <= eps || saturation[from] <= saturation[to]) return 0.0f;
+        return std::max(0.0f,
+            std::min(saturation[from] - saturation[to], capacity[to] - saturation[to]) / 4.0f);
+    };
+
+    // 셀마다 이웃의 유입/자신의 유출을 모아(gather) diffused에 기록 → 행 묶음 병렬 가능.
+    // 합산 순서는 행 우선 산란 순서와 같음: 위, 왼쪽 유입 → 유출(+x, -x, +y, -y) → 오른쪽, 아래 유입.
+    // 임계값 초과 셀은 모두 젖은 타일 안이므로 이웃까지 활성 구간 안에서 닫힘.
+    parallelRows(0, h, 0, w, [&](int y, int x0, int x1) {
+        const bool row   = y >= 1 && y < h - 1;  // 이 행이 내부 행
+        const bool above = y >= 2;               // 위 이웃이 내부 셀
+        const bool below = y < h - 2;            // 아래 이웃이 내부 셀
+        auto inner = [&](int x) { return row && x >= 1 && x < w - 1; };
+
+        // 가로 이동량은 옆 셀과 공유: x의 오른쪽 유출 = x+1의 왼쪽 유입 (반대 방향도 같음)
+        std::ptrdiff_t c        = m_grid.index(x0, y);
+        float          fromLeft = inner(x0 - 1) ? transfer(c - 1, c) : 0.0f;
+        float          toLeft   = inner(x0)     ? transfer(c, c - 1) : 0.0f;
+        for (int x = x0; x < x1; ++x, ++c) {
+            const bool  col       = x >= 1 && x < w - 1;
+            const float toRight   = inner(x)     ? transfer(c, c + 1) : 0.0f;
+            const float fromRight = inner(x + 1) ? transfer(c + 1, c) : 0.0f;
+
+            float v = saturation[c];
+            if (col && above) v += transfer(c - s, c);
+            v += fromLeft;
+            if (row && col) {
+                v -= toRight;
+                v -= toLeft;
+                v -= transfer(c, c + s);
+                v -= transfer(c, c - s);
+            }
+            v += fromRight;
+            if (col && below) v += transfer(c + s, c);
+            (*diffused)[c] = v;
 
-            flowTo(m_grid.index(x + 1, y));
-            flowTo(m_grid.index(x - 1, y));
-            flowTo(m_grid.index(x, y + 1));
-            flowTo(m_grid.index(x, y - 1));
+            fromLeft = toRight;
+            toLeft   = fromRight;
         }
-    }
-
-    for (int i = 0; i < w * h; ++i)
-        m_grid.saturation[i] = m_grid.saturationTemp[i];
-
-    // 포화도가 σ 초과인 셀을 젖은 상태로 표시
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            if (m_grid.saturation[m_grid.index(x, y)] > sigma)
-                m_grid.wetAreaMask[m_grid.index(x, y)] = 1.0f;
+    });
+
+    // 확산 결과를 반영하면서 포화도가 σ 초과인 셀을 젖은 상태로 표시.
+    // 평면을 맞바꾸면 반영은 교환으로 끝나고, 아니면 활성 구간 복사를 표시 순회에 합침
+    const bool swap = swapPays();
+    if (swap) commitScratch(diffused, saturation);
+    parallelRows(0, h, 0, w, [&](int y, int x0, int x1) {
+        for (std::ptrdiff_t c = m_grid.index(x0, y), end = c + (x1 - x0); c < end; ++c) {
+            if (!swap) saturation[c] = (*diffused)[c];
+            if (saturation[c] > sigma) m_grid.wetAreaMask[c] = 1.0f;
         }
-    }
+    });
 }
 
 // --- 템플릿 명시적 인스턴스화 -------------------------------------------------
 // 템플릿 정의가 .cpp에 있으므로 필요한 타입을 명시적으로 인스턴스화
-template void Simulation::advect<float>     (float*,      float*,      const glm::vec2*, float);
-template void Simulation::advect<glm::vec2> (glm::vec2*,  glm::vec2*,  const glm::vec2*, float);
-template void Simulation::advect<glm::vec3> (glm::vec3*,  glm::vec3*,  const glm::vec2*, float);
-template void Simulation::diffuse<float>    (float, float*,      const float*, float);
-template void Simulation::diffuse<glm::vec2>(float, glm::vec2*,  const float*, float);
-template void Simulation::diffuse<glm::vec3>(float, glm::vec3*,  const float*, float);
-template void Simulation::waterAdvect<float>(float*, float*, const glm::vec2*, const float*, float);
+template void Simulation::advect<1> (PlaneSet<1>, PlaneSet<1>, const float*, const float*, float);
+template void Simulation::advect<2> (PlaneSet<2>, PlaneSet<2>, const float*, const float*, float);
+template void Simulation::advect<3> (PlaneSet<3>, PlaneSet<3>, const float*, const float*, float);
+template void Simulation::diffuse<1>(float, PlaneSet<1>, PlaneSet<1>, const float*, float, DiffuseField);
+template void Simulation::diffuse<2>(float, PlaneSet<2>, PlaneSet<2>, const float*, float, DiffuseField);
+template void Simulation::diffuse<3>(float, PlaneSet<3>, PlaneSet<3>, const float*, float, DiffuseField);
+template void Simulation::diffuse<4>(float, PlaneSet<4>, PlaneSet<4>, const float*, float, DiffuseField);
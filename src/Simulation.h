@@ -7,20 +7,35 @@
 //
 #pragma once
 
+#include <array>
+#include <tuple>
+#include <vector>
 #include <glm/glm.hpp>
+
+#include "ActiveTiles.h"
+#include "BrushMask.h"
+#include "CanvasView.h"
 #include "Grid.h"
+#include "InputQueue.h"
 #include "KubelkaMunk.h"
+#include "Multigrid.h"
+#include "PlanarField.h"
+#include "Profiler.h"
+#include "RenderTiles.h"
+#include "ScratchPool.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+// 암묵적 확산 풀이 방식
+enum class DiffusionSolver : int {
+    RedBlack  = 0,  // 적색-흑색 가우스-자이델 (k*dt가 작을 때 가장 저렴)
+    Multigrid = 1,  // 마스크 적용 V-사이클 (점성이 크거나 dt가 클 때)
+};
 
-// 디버그용 렌더 채널 선택
-enum class DisplayMode : int {
-    Composite      = 0,  // 최종 합성 (침착 + 수면 안료)
-    Water          = 1,  // 수면 물 양
-    Saturation     = 2,  // 모세관 포화도
-    VelocityX      = 3,  // 수평 속도
-    WetMask        = 4,  // 젖은 영역 마스크
-    Evaporation    = 5,  // 가우시안 블러된 경계 지시자
-    Deposit        = 6,  // 침착된 안료
-    SurfacePigment = 7,  // 수면 안료
+// 실시간 루프의 스텝 크기 결정 방식 (Simulation::nextStepDt)
+enum class TimeStepping : int {
+    Fixed    = 0,  // 항상 fixedDt
+    Adaptive = 1,  // CFL: 최대 속도로 한 스텝에 cflTarget 셀 이하만 이동하도록 (maxDt 이하)
 };
 
 // UI에서 조절 가능한 물리 파라미터 (Van Laerhoven 2004 기준값)
@@ -37,7 +52,41 @@ struct SimulationParams {
     float waterAmount        = 2.00f;  // 브러시 1회 적용 물 양
     float pigmentAmount      = 0.20f;  // 브러시 1회 적용 안료 양
     int   brushRadius        = 10;     // 브러시 반경 (격자 셀 단위)
-    int   speedMultiplier    = 1;      // 프레임당 시뮬레이션 스텝 수
+    float brushSoftness      = 0.00f;  // 브러시 가장자리 감쇠 비율 (0 = 단단한 원판, 1 = 중심부터 감쇠)
+    float brushSpacing       = 0.50f;  // 스트로크 도장 간격 (반경 대비 비율, 최소 1셀)
+    int   speedMultiplier    = 1;      // 물/안료 이류 dt 배율
+    float timeScale          = 1.00f;  // 벽시계 1초당 시뮬레이션 시간 (초)
+    float fixedDt            = 1.0f / 60.0f;  // Fixed 스텝 크기 (초)
+    float maxDt              = 1.0f / 20.0f;  // Adaptive 스텝 상한 (초, 속도가 0에 가까울 때)
+    float cflTarget          = 0.50f;  // Adaptive: 스텝당 최대 이동 셀 수
+    int   maxSubsteps        = 8;      // 루프 반복당 최대 스텝 수 (stepBudgetMs = 0일 때)
+    float stepBudgetMs       = 0.0f;   // 루프 반복당 스텝 시간 예산 (ms, 0 = 실시간 누적기만)
+    float maxDebt            = 0.25f;  // 진행하지 못하고 이월하는 시뮬레이션 시간 상한 (초)
+    TimeStepping    timeStepping    = TimeStepping::Fixed;
+    int   threadCount        = 0;      // 커널 병렬 스레드 수 (0 = 하드웨어 스레드 수)
+    float diffusionTolerance = 1e-4f;  // 확산 솔버 상대 잔차 허용치 (max|r| / max|b|)
+    int   diffusionMaxIter   = 50;     // 확산 솔버 최대 반복 (적색+흑색 스윕 1쌍 또는 V-사이클 1회)
+    DiffusionSolver diffusionSolver = DiffusionSolver::RedBlack;
+    SimdLevel       simdLevel       = SimdLevel::Auto;  // 핫 루프 커널 구현 (검증 시 Scalar)
+};
+
+// 확산 솔버 통계를 기록하는 필드
+enum class DiffuseField : int {
+    Velocity = 0,
+    Water    = 1,
+    Pigment  = 2,  // 안료 농도 + 사전 곱셈 색상 (한 번에 풀이)
+    Count
+};
+
+const char* diffuseFieldName(DiffuseField field);
+
+// 마지막 step()의 솔버 통계 (패널/배치 출력용)
+struct SimulationStats {
+    static constexpr int k_fields = static_cast<int>(DiffuseField::Count);
+
+    std::array<int,   k_fields> diffuseIterations{};  // 수렴까지 쓴 반복 횟수
+    std::array<float, k_fields> diffuseResidual{};    // 마지막 반복의 상대 잔차
+    float maxVelocity = 0.0f;  // addHeightDifferenceVelocity 직후 최대 |속도| (셀/초)
 };
 
 // 수채화 시뮬레이션 전체 로직. Grid를 공유하며 step()을 매 프레임 호출.
@@ -45,40 +94,155 @@ class Simulation {
 public:
     Simulation(Grid& grid, const SimulationParams& params);
 
-    // 정규화 좌표 [0,1]에 브러시 적용. pigmentColor는 현재 선택된 안료 색상.
+    // 정규화 좌표 [0,1]의 커서로 스트로크 진행. pigmentColor는 현재 선택된 안료 색상.
+    // 누르고 있는 동안 이전 호출 위치부터 현재 위치까지 params.brushSpacing 간격으로
+    // 도장을 이어 찍고 (빠른 스트로크에서도 끊김 없음), 떼면 스트로크를 끝낸다.
     void applyBrush(float normX, float normY, bool isPressed,
                     const glm::vec3& pigmentColor);
 
-    // dt초만큼 시뮬레이션 진행 (프레임당 speedMultiplier회 호출됨)
+    // 입력 큐에서 time <= until인 이벤트를 순서대로 꺼내 브러시에 반영 (큐의 소비자).
+    // 메인 루프가 서브스텝마다 그 시간 구간의 끝을 until로 넘긴다. 버튼을 누르고 있으면
+    // 구간 안에 이동이 없어도 현재 커서 위치를 한 번 찍어 멈춘 브러시도 계속 적신다.
+    void consumeInput(InputQueue& queue, double until, const glm::vec3& pigmentColor);
+
+    // 정규화 좌표 [0,1]에 도장 하나 (스트로크 상태와 무관)
+    void stampBrush(float normX, float normY, const glm::vec3& pigmentColor);
+
+    // dt초만큼 시뮬레이션 진행. 젖은 타일이 없으면 (마른 캔버스) 커널을 건너뛴다.
     void step(float dt);
 
-    // 현재 displayMode에 맞게 grid.renderBuffer를 갱신
-    void updateRenderBuffer(DisplayMode mode);
+    // 정지 상태: 마지막 step에서 젖은 셀이 없었고 그 뒤 도장도 없으며 버튼도 떼어져 있음.
+    // 이때 step은 아무것도 바꾸지 않으므로 호출자는 새 입력이 올 때까지 쉬어도 된다.
+    bool isQuiescent() const { return m_settled && !m_pointerDown; }
+
+    // 마지막 step이 젖은 타일이 없어 커널을 건너뛰었는지 (스텝 비용 추정에서 제외할 때)
+    bool lastStepSkipped() const { return m_settled; }
+
+    // consumeInput 기준 버튼을 누르고 있는지 (누르는 동안은 멈춰 있어도 반복마다 도장)
+    bool pointerDown() const { return m_pointerDown; }
+
+    // 다음 step에 쓸 dt. Fixed면 params.fixedDt, Adaptive면 마지막 스텝의 최대 속도로
+    // 이류 이동량(속도 × dt × speedMultiplier)이 cflTarget 셀이 되는 값 (maxDt 이하).
+    float nextStepDt() const;
+
+    // mode에 맞게 캔버스의 region 영역을 합성해 out (region.floats()개, RGB)에 기록 (CPU 합성, 이미지 저장용)
+    void updateRenderBuffer(DisplayMode mode, const RenderRegion& region, float* out);
+
+    // mode의 GPU 합성(shader.frag)에 필요한 원시 필드를 region 영역에서 샘플링해 화면 타일 층에 기록.
+    // tile은 TileLayout::of(mode) 배치의 타일 하나, (tx, ty)는 region 왼쪽 위 텍셀의 타일 안 위치.
+    // withPaper가 false면 종이 층은 건너뜀 (종이는 캔버스가 바뀔 때만 달라짐).
+    void updateTileLayers(DisplayMode mode, const RenderRegion& region, float* tile,
+                          int tx, int ty, bool withPaper);
+
+    const Grid& grid() const { return m_grid; }
+
+    // 마지막 step()의 확산 반복 횟수/잔차
+    const SimulationStats& stats() const { return m_stats; }
+
+    // 현재 사용 중인 커널 구현 수준 (params.simdLevel을 CPU 지원 범위로 맞춘 값)
+    SimdLevel simdLevel() const { return m_kernels->level; }
+
+    // 젖은 영역 기반 활성 타일 (패널 표시용)
+    const ActiveTiles& activeTiles() const { return m_tiles; }
+
+    // 마지막 호출 이후 표시 내용이 바뀐 셀 사각형(ActiveTiles 타일 단위)마다 fn(x0, y0, x1, y1) 호출.
+    // 도장, 스텝의 활성 타일, 증발 지시자 영역, 초기화가 기록됨 (화면 타일 캐시 무효화용)
+    template<typename Fn>
+    void takeChangedTiles(Fn&& fn) { m_tiles.takeChanged(fn); }
+
+    // 격자를 applyBrush 밖에서 직접 수정했을 때 호출: 전체 타일을 다시 검사
+    void refreshActiveTiles();
+
+    // 격자 할당/초기화 (Grid::init, 종이 생성과 0 채우기를 스레드 풀로) 후 전체 타일 검사.
+    // 큰 캔버스의 시작 시간을 줄이기 위해 grid.init() 대신 사용. 반환: 할당 성공 여부
+    bool initCanvas();
+
+    // 캔버스 초기화: Grid::reset(종이 재사용, 스레드 풀로 0 채우기) 후 전체 타일 재검사
+    void resetCanvas();
 
     // UI 슬라이더가 직접 쓰는 파라미터
     SimulationParams params;
 
+    // 서브스텝별 소요 시간 기록 (메인 루프가 프레임마다 beginFrame 호출)
+    Profiler profiler;
+
 private:
+    // 서브스텝 단위 마이크로 벤치마크 (tools/Benchmark.cpp)
+    friend class SimulationBenchmark;
+
     Grid& m_grid;
 
+    // 젖은 타일 + 1타일 헤일로. 모든 서브스텝 커널은 이 구간만 순회.
+    ActiveTiles m_tiles;
+
+    // 서브스텝 임시 평면 (Grid::scratch 구역). 이류 출력, 확산 우변, 블러 작업 공간.
+    ScratchPool m_scratch;
+
+    // flowOutward 블러의 마지막 사각형 (x0,y0,x1,y1)
+    std::array<int, 4> m_evapRect = { 0, 0, 0, 0 };
+
+    // 마지막 step이 젖은 타일도 지울 증발 지시자도 없어 커널을 건너뛰었고 그 뒤 캔버스가
+    // 바뀌지 않음 (도장/초기화 시 해제)
+    bool m_settled = false;
+
+    // 행 묶음 병렬 실행용 상주 작업자 (params.threadCount에 맞춰 크기 조절)
+    ThreadPool m_pool;
+
+    SimulationStats m_stats;
+
+    // 확산 필드 성분 수별 멀티그리드 (수준 버퍼를 스텝 간 재사용)
+    std::tuple<Multigrid<1>, Multigrid<2>, Multigrid<3>, Multigrid<4>> m_multigrid;
+
+    // params.simdLevel에 해당하는 행 커널 테이블
+    const SimdKernels* m_kernels = nullptr;
+
+    // 브러시: 현재 반경/부드러움의 가중치 마스크, 진행 중인 스트로크의 마지막 도장 위치 (셀 좌표)
+    BrushMask m_brushMask;
+    bool      m_strokeActive = false;
+    glm::vec2 m_strokeLast{ 0.0f };
+
+    // consumeInput이 추적하는 포인터 상태 (정규화 좌표)
+    bool      m_pointerDown = false;
+    glm::vec2 m_pointer{ 0.0f };
+
     // --- 유체 솔버 ---
 
-    // 세미-라그랑지안 이류: 각 셀을 dt*vel만큼 역추적해 쌍선형 샘플링
-    template<typename T>
-    void advect(T* field, T* tempBuffer, const glm::vec2* vel, float dt);
+    // 세미-라그랑지안 이류: 각 셀을 dt*vel만큼 역추적해 src에서 쌍선형 샘플링, 활성 구간의
+    // dst에 기록 (성분 N개 평면). 호출자가 commitScratch로 src에 반영.
+    template<int N>
+    void advect(PlaneSet<N> src, PlaneSet<N> dst,
+                const float* velU, const float* velV, float dt);
 
-    // 가우스-자이델 확산: D += k*dt * Laplacian(D), wetAreaMask 내부만 적용
-    template<typename T>
-    void diffuse(float k, T* field, const float* mask, float dt);
+    // 암묵적 확산 (1 + 4k*dt)D - k*dt*이웃합 = D_old 를 params.diffusionSolver로 풀이.
+    // wetAreaMask 내부만 갱신, rhs는 D_old 보관용 작업 공간 (보통 Scratch 평면). 잔차가 허용치 이하가 되면
+    // 조기 종료하고 반복 횟수를 stats의 which 항목에 기록.
+    template<int N>
+    void diffuse(float k, PlaneSet<N> field, PlaneSet<N> rhs, const float* mask, float dt,
+                 DiffuseField which);
 
-    // 보존적 물 이류: 최대/최소 수량 경계를 준수
-    template<typename T>
-    void waterAdvect(T* field, T* tempBuffer, const glm::vec2* vel,
+    // 보존적 물 이류: 최대/최소 수량 경계를 준수 (SimdKernels::waterFluxRow).
+    // field를 읽어 활성 구간의 out에 기록, 호출자가 commitScratch로 field에 반영.
+    void waterAdvect(const float* field, float* out, const float* velU, const float* velV,
                      const float* mask, float dt);
 
+    // waterAdvect/advectPigment의 면 플럭스 커널 입력 (포인터는 셀 (0, 0) 기준으로 변환)
+    WaterFluxArgs waterFluxArgs(const float* field, float* out, const float* velU,
+                                const float* velV, const float* mask, float dt) const;
+
+    // 활성 구간 (y, [x0,x1)) 중 격자 가장자리 셀(면 플럭스 대상 밖)을 src → dst 복사
+    void copyEdgeCells(const float* src, float* dst, int y, int x0, int x1) const;
+
+    // 안료 이류 융합: 농도는 waterAdvect와 같은 보존적 면 플럭스, 사전 곱셈 색상은
+    // 세미-라그랑지안. 한 번의 행 순회에서 둘을 함께 처리해 속도/마스크를 셀당 한 번만 읽음.
+    // 결과는 임시 평면에 쓰고 모든 행을 마친 뒤 pigment/surfaceColor에 반영 (commitScratch).
+    void advectPigment(const float* velU, const float* velV, const float* mask, float dt);
+
+    // 셀 좌표 (x, y)를 중심으로 m_brushMask 도장 (원판 경계 상자 ∩ 격자 내부만 순회)
+    void stamp(float x, float y, const glm::vec3& pigmentColor);
+
     // --- 시뮬레이션 서브스텝 ---
 
-    void addHeightDifferenceVelocity(); // 수위 기울기 → 속도 추가
+    void addHeightDifferenceVelocity(); // 수위 기울기 → 속도 추가 (최대 |속도|를 stats에 기록)
     void applyBoundaryConditions();     // 건조 셀 속도 = 0 (no-slip)
     void flowOutward();                 // 경계 증발 및 건조 처리
     void updateSurfaceLayer(float dt);  // 안료 흡착/탈착 (수면 ↔ 종이)
@@ -87,11 +251,34 @@ private:
     void updateWater(float dt);
     void updatePigment(float dt);
 
-    // --- 헬퍼 ---
+    // 스텝 시작 시 활성 타일 재구성 (비활성이 된 타일은 속도 0)
+    void updateActiveTiles();
 
-    // 연속 좌표 p에서 필드를 쌍선형 보간
+    // 임시 평면의 커널 출력(활성 구간만 새 값)을 field에 반영. 활성 타일이 평면의 절반 이상을
+    // 덮으면 평면을 맞바꾸고(Scratch::swapInto) 나머지 셀만 이전 평면에서 옮기며, 아니면
+    // 활성 구간만 복사. 결과는 같고 옮기는 양은 어느 쪽이든 평면의 절반 이하.
     template<typename T>
-    T sampleBilinear(const T* field, const glm::vec2& p) const;
+    void commitScratch(Scratch<T>& out, T& field);
+
+    // commitScratch가 평면을 맞바꿀지 (활성 타일이 평면의 절반 이상)
+    bool swapPays() const;
+
+    // 활성 구간의 src 평면 N개를 dst로 복사
+    template<int N>
+    void copyActive(PlaneSet<N> src, PlaneSet<N> dst);
+
+    // 활성 구간 밖의 src 평면 N개 (유령 셀, 행 여백 포함 평면 전체에서)를 dst로 복사
+    template<int N>
+    void copyInactive(PlaneSet<N> src, PlaneSet<N> dst);
+
+    // params.threadCount에 맞춰 스레드 풀 크기 조절, params.simdLevel에 맞춰 커널 선택
+    void syncExecutionParams();
+
+    // 활성 구간 [yBegin,yEnd) × [xBegin,xEnd)를 스레드 풀에서 fn(y, x0, x1)로 처리
+    template<typename Fn>
+    void parallelRows(int yBegin, int yEnd, int xBegin, int xEnd, Fn&& fn);
+
+    // --- 헬퍼 ---
 
     const float k_maxWater = 10.0f;
     const float k_minWater =  0.1f;
@@ -0,0 +1,276 @@
+//
+// SimulationThread.cpp
+// WaterColorSimulation
+//
+// 시뮬레이션 전용 스레드 구현
+//
+#include "SimulationThread.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+// 반복 최소 간격. 젖은 영역이 작으면 step이 거의 공짜라 제한이 없으면
+// 스냅샷 복사만 반복하며 코어 하나를 소모한다 (완전히 멈추면 유휴 대기).
+constexpr double k_minPeriod = 1.0 / 240.0;  // 초
+
+// loopHz 지수 이동 평균 계수
+constexpr float k_rateSmoothing = 0.05f;
+
+// 스텝 비용 추정 (예산 모드). 첫 측정 전에는 60Hz 한 프레임으로 보수적으로 잡아
+// 밀린 최소 1스텝만 진행하고, 첫 측정값으로 바꾼 뒤 지수 이동 평균으로 따라간다.
+constexpr float k_initialStepCostMs = 1000.0f / 60.0f;
+constexpr float k_costSmoothing     = 0.1f;
+
+} // anonymous namespace
+
+SimulationThread::SimulationThread(Simulation& sim, Grid& grid, InputQueue& input)
+    : m_sim(sim), m_grid(grid), m_input(input), m_stepCostMs(k_initialStepCostMs) {}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start(const SimulationSettings& settings) {
+    if (m_thread.joinable()) return;
+
+    m_tileVersions.resize(m_grid.width, m_grid.height);
+    applySettings(settings);
+    m_settings.fill(settings);
+
+    // 렌더 스레드가 첫 반복 전에도 그릴 수 있도록 세 슬롯 모두 현재 캔버스로 채움
+    SimulationSnapshot initial;
+    renderInto(initial);
+    initial.tileCount     = m_sim.activeTiles().tileCount();
+    initial.simdLevel     = m_sim.simdLevel();
+    initial.paramsVersion = settings.version;
+    m_snapshots.fill(initial);
+
+    m_quit.store(false);
+    m_thread = std::thread([this] { run(); });
+}
+
+void SimulationThread::stop() {
+    if (!m_thread.joinable()) return;
+    m_quit.store(true);
+    wake();
+    m_thread.join();
+}
+
+void SimulationThread::publishSettings(const SimulationSettings& settings) {
+    m_settings.back() = settings;
+    m_settings.publish();
+    wake();
+}
+
+void SimulationThread::wake() {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeRequested = true;
+    }
+    m_wakeCondition.notify_one();
+}
+
+void SimulationThread::waitForWake() {
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wakeCondition.wait(lock, [this] { return m_wakeRequested || m_quit.load(); });
+    m_wakeRequested = false;
+}
+
+bool SimulationThread::beginRenderWait() {
+    // 플래그를 세운 뒤 게시를 확인 (게시 쪽은 게시한 뒤 플래그를 확인) → 어느 쪽이든 한쪽은 봄
+    m_renderWaiting.store(true);
+    if (!m_snapshots.pending()) return true;
+    m_renderWaiting.store(false);
+    return false;
+}
+
+void SimulationThread::applySettings(const SimulationSettings& settings) {
+    if (settings.displayMode != m_current.displayMode) m_modeVersion = ++m_epoch;
+    m_current    = settings;
+    m_sim.params = settings.params;
+}
+
+void SimulationThread::run() {
+    using Clock = std::chrono::steady_clock;
+
+    // 첫 반복도 최소 간격만큼 진행한 것으로 간주 (loopHz 급등 방지)
+    double lastTime = inputClock() - k_minPeriod;
+    float  loopHz   = 0.0f;
+
+    while (!m_quit.load(std::memory_order_relaxed)) {
+        const Clock::time_point iterationStart = Clock::now();
+        m_sim.profiler.beginFrame();
+
+        if (m_settings.update()) applySettings(m_settings.front());
+        if (m_resetRequested.exchange(false, std::memory_order_acq_rel)) {
+            m_sim.resetCanvas();
+        }
+        if (const char* path = m_dumpPath.exchange(nullptr, std::memory_order_acq_rel)) {
+            if (m_sim.profiler.dumpCsv(path))
+                std::cout << "Profile written to " << path << "\n";
+        }
+
+        const double currentTime = inputClock();
+        const float  wallDt      = static_cast<float>(currentTime - lastTime);
+        lastTime                 = currentTime;
+
+        // 누적기: 벽시계 경과 × timeScale만큼 시뮬레이션 시간을 쌓고 nextStepDt() 크기로 소비.
+        // 스텝 k는 끝나는 시뮬레이션 시각에 대응하는 벽시계 시각까지의 입력으로 브러시를 적용한 뒤 진행.
+        // 정지 상태면 step은 아무것도 바꾸지 않으므로 건너뛰고 시간도 쌓지 않음
+        // (새 입력이 있으면 평소처럼 서브스텝 시각에 맞춰 적용)
+        const bool settled = m_sim.isQuiescent() && !m_input.front();
+        if (m_current.running && settled) m_accumulator = 0.0f;
+
+        int substeps = 0;
+        if (m_current.running && !settled) {
+            const float timeScale = std::max(1e-3f, m_sim.params.timeScale);
+            const float budgetMs  = m_sim.params.stepBudgetMs;
+            const Clock::time_point stepsStart = Clock::now();
+            m_accumulator += wallDt * timeScale;
+
+            for (float dt = m_sim.nextStepDt();; dt = m_sim.nextStepDt()) {
+                const bool owed = m_accumulator >= dt;
+                if (budgetMs > 0.0f) {
+                    // 예산 모드: 스텝당 비용 추정(m_stepCostMs)으로 남은 예산에 들어갈 때만 진행.
+                    // 밀린 시간이 없어도 예산이 남으면 진행해 건조를 앞당기고,
+                    // 밀린 시간이 있으면 예산과 무관하게 최소 1스텝은 진행.
+                    const float elapsedMs = std::chrono::duration<float, std::milli>(
+                        Clock::now() - stepsStart).count();
+                    if (!(owed && substeps == 0) && elapsedMs + m_stepCostMs > budgetMs) break;
+                } else if (!owed || substeps >= std::max(1, m_sim.params.maxSubsteps)) {
+                    break;
+                }
+                m_accumulator -= dt;
+                m_sim.consumeInput(m_input, currentTime - m_accumulator / timeScale,
+                                   m_current.pigmentColor);
+                const Clock::time_point stepStart = Clock::now();
+                m_sim.step(dt);
+                ++substeps;
+                // 커널을 건너뛴 스텝(마른 캔버스)은 거의 0ms라 추정을 끌어내리므로 제외
+                if (!m_sim.lastStepSkipped()) {
+                    const float ms = std::chrono::duration<float, std::milli>(
+                        Clock::now() - stepStart).count();
+                    if (m_stepCostMeasured) m_stepCostMs += k_costSmoothing * (ms - m_stepCostMs);
+                    else                    m_stepCostMs  = ms;
+                    m_stepCostMeasured = true;
+                }
+                // 정지 상태가 되면 남은 예산/시간을 빈 스텝으로 쓰지 않음
+                if (m_sim.isQuiescent() && !m_input.front()) break;
+            }
+            // 진행하지 못한 시간은 빚으로 이월 (상한 maxDebt: 긴 멈칫 뒤에는 큰 dt나 무한 추격
+            // 대신 느려짐). 예산으로 앞서 나간 시간은 빚으로 치지 않음.
+            m_accumulator = std::min(std::max(m_accumulator, 0.0f),
+                                     std::max(0.0f, m_sim.params.maxDebt));
+        }
+        m_sim.consumeInput(m_input, currentTime, m_current.pigmentColor);
+
+        if (wallDt > 0.0f)
+            loopHz = loopHz > 0.0f ? loopHz + k_rateSmoothing * (1.0f / wallDt - loopHz) : 1.0f / wallDt;
+        // 더 진행할 것이 없으면 (정지 상태 또는 일시 정지, 남은 입력 없음, 다시 합성한 텍셀 없음)
+        // 유휴 스냅샷을 게시하고 wake()까지 잠듦. 깨어난 뒤의 경과 시간은 진행하지 않음
+        const bool quiet = (m_sim.isQuiescent() || (!m_current.running && !m_sim.pointerDown()))
+                        && !m_input.front();
+        if (publishSnapshot(loopHz, substeps, quiet)) {
+            waitForWake();
+            lastTime = inputClock() - k_minPeriod;
+            continue;
+        }
+
+        std::this_thread::sleep_until(iterationStart
+            + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(k_minPeriod)));
+    }
+}
+
+bool SimulationThread::publishSnapshot(float loopHz, int substeps, bool quiet) {
+    SimulationSnapshot& snap = m_snapshots.back();
+    renderInto(snap);
+    snap.idle          = quiet && snap.texelsUpdated == 0;
+    snap.stats         = m_sim.stats();
+    snap.activeTiles   = m_sim.activeTiles().activeCount();
+    snap.tileCount     = m_sim.activeTiles().tileCount();
+    snap.simdLevel     = m_sim.simdLevel();
+    snap.loopHz        = loopHz;
+    snap.substeps      = substeps;
+    snap.stepDt        = m_sim.nextStepDt();
+    snap.stepCostMs    = m_stepCostMs;
+    snap.debt          = m_accumulator;
+    snap.paramsVersion = m_current.version;
+    for (int i = 0; i < Profiler::k_stageCount; ++i)
+        snap.profile[i] = m_sim.profiler.stats(static_cast<ProfileStage>(i));
+    const bool idle = snap.idle;
+    m_snapshots.publish();
+
+    // 이벤트 대기 중인 렌더 스레드를 깨움 (beginRenderWait와 짝)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_renderWaiting.exchange(false) && m_renderWake) m_renderWake();
+    return idle;
+}
+
+void SimulationThread::renderInto(SimulationSnapshot& snap) {
+    // 지난 합성 이후 바뀐 셀 → 그 셀을 샘플링하는 모든 수준의 화면 타일에 새 버전
+    const uint64_t epoch = ++m_epoch;
+    m_sim.takeChangedTiles([&](int x0, int y0, int x1, int y1) {
+        m_tileVersions.markChanged(x0, y0, x1, y1, epoch);
+    });
+
+    const int level = tileLevel(m_current.view.cellsPerPixel);
+    m_visible.clear();
+    forEachVisibleTile(m_current.view, m_grid.width, m_grid.height, level, [&](const TileKey& key) {
+        m_visible.emplace_back();
+        m_tileVersions.read(key, m_modeVersion, m_visible.back());
+    });
+
+    // 표시 모드가 바뀌면 층 배치가 달라지므로 이 슬롯의 사본은 쓰지 않음
+    const DisplayMode mode   = m_current.displayMode;
+    const TileLayout  layout = TileLayout::of(mode);
+    if (snap.tileMode != mode) snap.tiles.clear();
+    snap.tileMode      = mode;
+    snap.tileLevel     = level;
+    snap.texelsUpdated = 0;
+
+    // now 타일에서 had 사본보다 새 블록 사각형만 tile(타일 하나의 층들)에 제자리로 (종이 층 제외)
+    auto updateDirty = [&](const TileImage& now, const BlockVersions& had, float* tile) {
+        const TileKey&     key  = now.key;
+        const int          s    = key.cellsPerTexel();
+        const RenderRegion base = key.region();
+        forEachDirtyRect(now.blocks, had, [&](int tx0, int ty0, int tx1, int ty1) {
+            const RenderRegion sub{ base.x0 + tx0 * s, base.y0 + ty0 * s,
+                                    base.x0 + tx1 * s, base.y0 + ty1 * s, s };
+            m_sim.updateTileLayers(mode, sub, tile, tx0, ty0, false);
+            snap.texelsUpdated += (tx1 - tx0) * (ty1 - ty0);
+        });
+    };
+    // 같은 타일 집합 (뷰가 그대로): 이 슬롯의 사본보다 새 블록만 제자리에
+    const bool sameTiles = snap.tiles.size() == m_visible.size()
+        && std::equal(m_visible.begin(), m_visible.end(), snap.tiles.begin(),
+                      [](const TileImage& a, const TileImage& b) { return a.key == b.key; });
+    if (sameTiles) {
+        for (size_t i = 0; i < m_visible.size(); ++i) {
+            if (snap.tiles[i].version == m_visible[i].version) continue;
+            updateDirty(m_visible[i], snap.tiles[i].blocks, snap.tileLayers.data() + i * layout.floats);
+            snap.tiles[i] = m_visible[i];
+        }
+        return;
+    }
+
+    // 이동/확대로 집합이 바뀜: 슬롯에 남은 타일은 복사한 뒤 새 블록만, 나머지는 종이까지 전부
+    m_spare.resize(m_visible.size() * layout.floats);
+    for (size_t i = 0; i < m_visible.size(); ++i) {
+        float* const out = m_spare.data() + i * layout.floats;
+        const auto   old = std::find_if(snap.tiles.begin(), snap.tiles.end(),
+                                        [&](const TileImage& t) { return t.key == m_visible[i].key; });
+        if (old != snap.tiles.end()) {
+            const float* src = snap.tileLayers.data() + (old - snap.tiles.begin()) * layout.floats;
+            std::copy_n(src, layout.floats, out);
+            updateDirty(m_visible[i], old->blocks, out);
+        } else {
+            m_sim.updateTileLayers(mode, m_visible[i].key.region(), out, 0, 0, true);
+            snap.texelsUpdated += static_cast<int>(k_tileArea);
+        }
+    }
+    std::swap(snap.tileLayers, m_spare);
+    std::swap(snap.tiles, m_visible);
+}
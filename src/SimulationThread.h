@@ -0,0 +1,155 @@
+//
+// SimulationThread.h
+// WaterColorSimulation
+//
+// 시뮬레이션 전용 스레드. 렌더 스레드(V-Sync에 묶인 메인 루프)와 독립된 속도로
+// 입력 소비 → 누적 시간만큼 step (Simulation::nextStepDt) → 화면에 보이는 타일 중 내용이 바뀐 것만
+// 합성을 반복하고, 합성된 화면 타일과 패널 표시용 통계를 삼중 버퍼 스냅샷으로 게시한다.
+// 진행할 것도 다시 합성할 것도 없으면 (Simulation::isQuiescent, 입력 없음) 유휴 스냅샷을 한 번
+// 게시하고 wake()까지 잠든다. 렌더 스레드도 그 스냅샷을 보면 이벤트 대기로 들어간다.
+//
+// 스레드 간 통신은 유휴 대기(조건 변수)를 빼면 모두 무잠금:
+//   렌더 → 시뮬레이션  SimulationSettings 복사본 (버전 번호, 삼중 버퍼로 원자 교환)
+//                     포인터 이벤트 (InputQueue), 초기화/프로파일 저장 요청 (원자 플래그)
+//   시뮬레이션 → 렌더  SimulationSnapshot (삼중 버퍼)
+// 시작 후 Simulation/Grid는 이 스레드만 만진다.
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "InputQueue.h"
+#include "Profiler.h"
+#include "RenderTiles.h"
+#include "Simulation.h"
+#include "TripleBuffer.h"
+
+// 렌더 스레드가 편집하는 설정. 바뀔 때마다 version을 올려 통째로 게시.
+struct SimulationSettings {
+    SimulationParams params;
+    bool             running      = false;  // step 진행 여부 (false여도 브러시는 적용)
+    DisplayMode      displayMode  = DisplayMode::Composite;
+    glm::vec3        pigmentColor { 0.0f };  // 현재 선택된 안료 색상
+    CanvasView       view;                   // 화면 뷰 (합성할 화면 타일을 정함)
+    uint64_t         version      = 0;
+};
+
+// 시뮬레이션 스레드가 한 반복을 마칠 때마다 게시하는 결과
+struct SimulationSnapshot {
+    std::vector<TileImage> tiles;                // view에 보이는 화면 타일과 내용 버전
+    std::vector<float>     tileLayers;           // tiles 순서대로 타일마다 TileLayout::of(tileMode).floats
+    DisplayMode            tileMode        = DisplayMode::Composite;  // tileLayers의 층 배치
+    int                    tileLevel       = 0;  // tiles의 밉 수준
+    int                    texelsUpdated   = 0;  // 이 스냅샷을 만들며 새로 채운 텍셀 수 (바뀐 블록만)
+    SimulationStats        stats;
+    int                    activeTiles     = 0;
+    int                    tileCount       = 0;
+    SimdLevel              simdLevel       = SimdLevel::Scalar;
+    float                  loopHz          = 0.0f;  // 시뮬레이션 루프 반복률 (지수 이동 평균)
+    int                    substeps        = 0;     // 이 반복에서 진행한 스텝 수
+    float                  stepDt          = 0.0f;  // 다음 스텝의 dt (Simulation::nextStepDt, 초)
+    float                  stepCostMs      = 0.0f;  // 스텝 1회 비용 추정 (ms, 건너뛴 스텝 제외 이동 평균)
+    float                  debt            = 0.0f;  // 이월된 시뮬레이션 시간 (초)
+    uint64_t               paramsVersion   = 0;     // 이 스냅샷을 만들 때 적용된 설정 버전
+    bool                   idle            = false;  // 게시 후 wake()까지 대기 (다음 스냅샷도 같음)
+    std::array<Profiler::Stats, Profiler::k_stageCount> profile{};  // Simulation::profiler 통계
+};
+
+class SimulationThread {
+public:
+    SimulationThread(Simulation& sim, Grid& grid, InputQueue& input);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&)            = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // 초기 설정을 적용하고 첫 스냅샷을 만든 뒤 스레드 시작
+    void start(const SimulationSettings& settings);
+
+    // 스레드 종료 대기 (소멸자에서도 호출)
+    void stop();
+
+    // --- 렌더 스레드 전용 ---
+
+    // 설정 게시. 시뮬레이션 스레드는 다음 반복 시작 시 최신 버전만 적용.
+    void publishSettings(const SimulationSettings& settings);
+
+    // 다음 반복 시작 시 캔버스 초기화 (Simulation::resetCanvas)
+    void requestReset() {
+        m_resetRequested.store(true, std::memory_order_release);
+        wake();
+    }
+
+    // 다음 반복 시작 시 Simulation::profiler를 path에 CSV로 저장 (path는 정적 수명 문자열)
+    void requestProfileDump(const char* path) {
+        m_dumpPath.store(path, std::memory_order_release);
+        wake();
+    }
+
+    // 유휴 대기 중인 시뮬레이션 스레드를 깨움 (입력 큐에 이벤트를 넣은 뒤 호출).
+    // publishSettings / requestReset / requestProfileDump는 스스로 깨운다.
+    void wake();
+
+    // 렌더 스레드가 이벤트 대기(glfwWaitEvents)에 들어가기 직전 호출. 아직 가져가지 않은
+    // 스냅샷이 있으면 false (대기하지 말 것). true면 다음 게시 때 renderWake 콜백이 불린다.
+    bool beginRenderWait();
+
+    // 렌더 스레드 대기 중 스냅샷이 게시되면 시뮬레이션 스레드에서 부를 콜백 (start 전에 설정,
+    // 예: glfwPostEmptyEvent)
+    void setRenderWake(std::function<void()> renderWake) { m_renderWake = std::move(renderWake); }
+
+    // 최신 스냅샷을 가져옴. 반환: 지난 호출 이후 새 스냅샷이 있었는지
+    bool acquireSnapshot() { return m_snapshots.update(); }
+
+    // acquireSnapshot으로 가져온 스냅샷 (다음 acquireSnapshot 전까지 유효)
+    const SimulationSnapshot& snapshot() const { return m_snapshots.front(); }
+
+private:
+    void run();
+    void applySettings(const SimulationSettings& settings);
+    bool publishSnapshot(float loopHz, int substeps, bool quiet);
+    void waitForWake();
+    void renderInto(SimulationSnapshot& snap);
+
+    Simulation& m_sim;
+    Grid&       m_grid;
+    InputQueue& m_input;
+
+    std::thread                      m_thread;
+    std::atomic<bool>                m_quit{ false };
+    std::atomic<bool>                m_resetRequested{ false };
+    std::atomic<const char*>         m_dumpPath{ nullptr };
+    TripleBuffer<SimulationSettings> m_settings;
+    TripleBuffer<SimulationSnapshot> m_snapshots;
+
+    // 유휴 대기: wake()가 m_wakeRequested를 세우고 깨움.
+    // 렌더 스레드가 대기에 들어가면 m_renderWaiting → 다음 게시 때 m_renderWake
+    std::mutex              m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    bool                    m_wakeRequested = false;
+    std::atomic<bool>       m_renderWaiting{ false };
+    std::function<void()>   m_renderWake;
+
+    // 시뮬레이션 스레드 소유: 마지막으로 적용한 설정, 아직 진행하지 않은 시뮬레이션 시간 (초),
+    // 예산 모드의 스텝 비용 추정 (ms, 실제로 커널을 돈 스텝만)
+    SimulationSettings m_current;
+    float              m_accumulator      = 0.0f;
+    float              m_stepCostMs       = 0.0f;
+    bool               m_stepCostMeasured = false;
+
+    // 화면 타일 버전: 합성마다 m_epoch를 올려 그동안 바뀐 셀의 타일에 기록.
+    // 표시 모드가 바뀌면 모든 타일이 m_modeVersion보다 새 버전이어야 함.
+    TileVersions           m_tileVersions;
+    uint64_t               m_epoch       = 0;
+    uint64_t               m_modeVersion = 0;
+    std::vector<TileImage> m_visible;  // 이번 합성에서 보이는 타일 (재사용)
+    std::vector<float>     m_spare;    // 타일 집합이 바뀔 때 새 tileLayers (재사용)
+};
@@ -0,0 +1,185 @@
+//
+// StrokeScript.cpp
+// WaterColorSimulation
+//
+// 스트로크 스크립트 파싱 및 실행
+//
+#include "StrokeScript.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// 비교용 정규화: 소문자화, 영숫자 외 문자 제거 ("Hooker's Green" → "hookersgreen")
+std::string normalizeName(const std::string& name) {
+    std::string out;
+    for (char ch : name) {
+        if (std::isalnum(static_cast<unsigned char>(ch)))
+            out += static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+    return out;
+}
+
+struct PigmentPreset {
+    const char* name;
+    void (PigmentInfo::*apply)();
+};
+
+const PigmentPreset k_presets[] = {
+    { "QuinacridoneMagenta", &PigmentInfo::setQuinacridoneMagenta },
+    { "IndianRed",           &PigmentInfo::setIndianRed           },
+    { "CadmiumYellow",       &PigmentInfo::setCadmiumYellow       },
+    { "HookersGreen",        &PigmentInfo::setHookersGreen        },
+    { "CeruleanBlue",        &PigmentInfo::setCeruleanBlue        },
+    { "BurntUmber",          &PigmentInfo::setBurntUmber          },
+    { "CadmiumRed",          &PigmentInfo::setCadmiumRed          },
+    { "InterferenceLilac",   &PigmentInfo::setInterferenceLilac   },
+    { "FrenchUltramarine",   &PigmentInfo::setFrenchUltramarine   },
+};
+
+} // anonymous namespace
+
+bool setPigmentByName(PigmentInfo& pigment, const std::string& name) {
+    const std::string key = normalizeName(name);
+    for (const PigmentPreset& preset : k_presets) {
+        if (normalizeName(preset.name) == key) {
+            (pigment.*preset.apply)();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool StrokeScript::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "[ERROR] Cannot open stroke script: " << path << "\n";
+        return false;
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return parse(ss.str());
+}
+
+bool StrokeScript::parse(const std::string& text) {
+    m_commands.clear();
+
+    std::istringstream input(text);
+    std::string        rawLine;
+    int                lineNo = 0;
+
+    while (std::getline(input, rawLine)) {
+        ++lineNo;
+        const size_t hash = rawLine.find('#');
+        if (hash != std::string::npos) rawLine.erase(hash);
+
+        std::istringstream tokens(rawLine);
+        std::string keyword;
+        if (!(tokens >> keyword)) continue;  // 빈 줄
+
+        StrokeCommand cmd;
+        cmd.line = lineNo;
+        bool ok  = true;
+
+        if (keyword == "pigment") {
+            cmd.type = StrokeCommand::Type::Pigment;
+            std::getline(tokens >> std::ws, cmd.name);
+            PigmentInfo probe;
+            ok = !cmd.name.empty() && setPigmentByName(probe, cmd.name);
+        } else if (keyword == "radius") {
+            cmd.type = StrokeCommand::Type::Radius;
+            ok = static_cast<bool>(tokens >> cmd.count) && cmd.count > 0;
+        } else if (keyword == "water") {
+            cmd.type = StrokeCommand::Type::Water;
+            ok = static_cast<bool>(tokens >> cmd.args[0]);
+        } else if (keyword == "amount") {
+            cmd.type = StrokeCommand::Type::Amount;
+            ok = static_cast<bool>(tokens >> cmd.args[0]);
+        } else if (keyword == "softness") {
+            cmd.type = StrokeCommand::Type::Softness;
+            ok = static_cast<bool>(tokens >> cmd.args[0])
+                 && cmd.args[0] >= 0.0f && cmd.args[0] <= 1.0f;
+        } else if (keyword == "spacing") {
+            cmd.type = StrokeCommand::Type::Spacing;
+            ok = static_cast<bool>(tokens >> cmd.args[0]) && cmd.args[0] > 0.0f;
+        } else if (keyword == "dab") {
+            cmd.type = StrokeCommand::Type::Dab;
+            ok = static_cast<bool>(tokens >> cmd.args[0] >> cmd.args[1]);
+        } else if (keyword == "stroke") {
+            cmd.type = StrokeCommand::Type::Stroke;
+            ok = static_cast<bool>(tokens >> cmd.args[0] >> cmd.args[1]
+                                          >> cmd.args[2] >> cmd.args[3]);
+            // 도장 수 생략 시 0 → 실행 시 반경 기준 간격으로 결정
+            if (ok && !(tokens >> cmd.count)) cmd.count = 0;
+        } else if (keyword == "step") {
+            cmd.type = StrokeCommand::Type::Step;
+            ok = static_cast<bool>(tokens >> cmd.count) && cmd.count >= 0;
+        } else {
+            std::cerr << "[ERROR] Stroke script line " << lineNo
+                      << ": unknown command '" << keyword << "'\n";
+            return false;
+        }
+
+        if (!ok) {
+            std::cerr << "[ERROR] Stroke script line " << lineNo
+                      << ": invalid arguments for '" << keyword << "'\n";
+            return false;
+        }
+        m_commands.push_back(cmd);
+    }
+    return true;
+}
+
+void StrokeScript::run(Simulation& sim, PigmentInfo& pigment, float dt) const {
+    for (const StrokeCommand& cmd : m_commands) {
+        switch (cmd.type) {
+        case StrokeCommand::Type::Pigment:
+            setPigmentByName(pigment, cmd.name);
+            break;
+        case StrokeCommand::Type::Radius:
+            sim.params.brushRadius = cmd.count;
+            break;
+        case StrokeCommand::Type::Water:
+            sim.params.waterAmount = cmd.args[0];
+            break;
+        case StrokeCommand::Type::Amount:
+            sim.params.pigmentAmount = cmd.args[0];
+            break;
+        case StrokeCommand::Type::Softness:
+            sim.params.brushSoftness = cmd.args[0];
+            break;
+        case StrokeCommand::Type::Spacing:
+            sim.params.brushSpacing = cmd.args[0];
+            break;
+        case StrokeCommand::Type::Dab:
+            sim.stampBrush(cmd.args[0], cmd.args[1], pigment.colorW);
+            break;
+        case StrokeCommand::Type::Stroke: {
+            int samples = cmd.count;
+            if (samples <= 0) {
+                // 기본 간격: params.brushSpacing × 반경 (격자 셀 단위로 환산)
+                const float dx = (cmd.args[2] - cmd.args[0]) * sim.grid().width;
+                const float dy = (cmd.args[3] - cmd.args[1]) * sim.grid().height;
+                const float spacing = std::max(1.0f, sim.params.brushSpacing
+                                                         * sim.params.brushRadius);
+                samples = 1 + static_cast<int>(std::sqrt(dx * dx + dy * dy) / spacing);
+            }
+            for (int i = 0; i <= samples; ++i) {
+                const float t = static_cast<float>(i) / static_cast<float>(samples);
+                sim.stampBrush(cmd.args[0] + (cmd.args[2] - cmd.args[0]) * t,
+                               cmd.args[1] + (cmd.args[3] - cmd.args[1]) * t,
+                               pigment.colorW);
+            }
+            break;
+        }
+        case StrokeCommand::Type::Step:
+            for (int i = 0; i < cmd.count; ++i) sim.step(dt);
+            break;
+        }
+    }
+}
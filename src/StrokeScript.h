@@ -0,0 +1,53 @@
+//
+// StrokeScript.h
+// WaterColorSimulation
+//
+// 헤드리스 실행용 스트로크 스크립트 (한 줄에 명령 하나, '#'은 주석)
+//
+//   pigment <이름>                     안료 변경 (예: FrenchUltramarine)
+//   radius  <셀>                       브러시 반경
+//   water   <양>                       브러시 물 양
+//   amount  <양>                       브러시 안료 양
+//   softness <0..1>                    브러시 가장자리 감쇠 (0 = 단단한 원판)
+//   spacing <비율>                     stroke 기본 도장 간격 (반경 대비)
+//   dab     <x> <y>                    정규화 좌표 [0,1]에 한 번 찍기
+//   stroke  <x0> <y0> <x1> <y1> [n]    두 점 사이를 n개 도장으로 잇기 (생략 시 spacing 간격)
+//   step    <n>                        시뮬레이션 n 스텝 진행
+//
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "KubelkaMunk.h"
+#include "Simulation.h"
+
+struct StrokeCommand {
+    enum class Type { Pigment, Radius, Water, Amount, Softness, Spacing, Dab, Stroke, Step };
+
+    Type        type;
+    std::string name;           // Pigment 전용
+    float       args[4] = {};   // 좌표/수치 인자
+    int         count   = 0;    // Stroke 도장 수, Step 스텝 수, Radius 반경
+    int         line    = 0;    // 오류 보고용 원본 줄 번호
+};
+
+class StrokeScript {
+public:
+    // 파일을 파싱. 실패 시 stderr에 줄 번호와 함께 출력하고 false 반환.
+    bool load(const std::string& path);
+
+    // 문자열을 파싱 (load와 동일 규칙)
+    bool parse(const std::string& text);
+
+    // 명령을 순서대로 실행. step 명령은 dt로 sim.step을 호출.
+    void run(Simulation& sim, PigmentInfo& pigment, float dt) const;
+
+    const std::vector<StrokeCommand>& commands() const { return m_commands; }
+
+private:
+    std::vector<StrokeCommand> m_commands;
+};
+
+// 안료 이름(대소문자 무시, 공백/' 무시)으로 프리셋 적용. 알 수 없으면 false.
+bool setPigmentByName(PigmentInfo& pigment, const std::string& name);
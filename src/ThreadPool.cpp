@@ -0,0 +1,97 @@
+//
+// ThreadPool.cpp
+// WaterColorSimulation
+//
+// 상주 작업자 스레드 풀 구현
+//
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads) {
+    resize(threads);
+}
+
+ThreadPool::~ThreadPool() {
+    stopWorkers();
+}
+
+int ThreadPool::hardwareThreads() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? static_cast<int>(n) : 1;
+}
+
+void ThreadPool::resize(int threads) {
+    threads = std::max(1, threads);
+    if (threads == size()) return;
+
+    stopWorkers();
+    m_stop = false;
+    for (int i = 0; i < threads - 1; ++i)
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, m_generation);
+}
+
+void ThreadPool::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_workers) t.join();
+    m_workers.clear();
+}
+
+void ThreadPool::run(int begin, int end, TaskFn call, void* ctx) {
+    // 스레드당 약 4개 묶음 → 활성 타일 분포가 고르지 않아도 부하 분산
+    const int rows = end - begin;
+    const int target = size() * 4;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_call      = call;
+        m_ctx       = ctx;
+        m_begin     = begin;
+        m_end       = end;
+        m_bandSize  = std::max(1, (rows + target - 1) / target);
+        m_bandCount = (rows + m_bandSize - 1) / m_bandSize;
+        m_nextBand.store(0, std::memory_order_relaxed);
+        m_pending   = static_cast<int>(m_workers.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    executeBands();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+    m_call = nullptr;
+}
+
+void ThreadPool::executeBands() {
+    for (;;) {
+        const int band = m_nextBand.fetch_add(1, std::memory_order_relaxed);
+        if (band >= m_bandCount) break;
+        const int b = m_begin + band * m_bandSize;
+        const int e = std::min(m_end, b + m_bandSize);
+        m_call(m_ctx, b, e);
+    }
+}
+
+// seen: 생성 시점의 세대. 작업자가 실제로 시작되기 전에 run()이 세대를 올려도
+// 그 작업을 놓치지 않도록 resize에서 넘겨받는다.
+void ThreadPool::workerLoop(uint64_t seen) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+        }
+
+        executeBands();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0) m_done.notify_one();
+        }
+    }
+}
@@ -0,0 +1,75 @@
+//
+// ThreadPool.h
+// WaterColorSimulation
+//
+// Simulation이 소유하는 상주 작업자 스레드 풀.
+// parallelFor는 [begin, end) 행 범위를 작은 행 묶음(band)으로 나눠 호출 스레드와
+// 작업자들이 원자 카운터로 가져가 처리한다. 셀마다 자기 자신만 쓰는 gather 커널은
+// 분할 방식과 무관하게 단일 스레드 실행과 비트 단위로 같은 결과를 낸다.
+//
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class ThreadPool {
+public:
+    // threads: 호출 스레드를 포함한 총 스레드 수 (1이면 작업자 없음)
+    explicit ThreadPool(int threads = 1);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 작업자 수 변경 (parallelFor 실행 중에는 호출 금지)
+    void resize(int threads);
+    int  size() const { return static_cast<int>(m_workers.size()) + 1; }
+
+    // fn(bandBegin, bandEnd)를 [begin, end)를 덮는 행 묶음마다 호출하고 모두 끝날 때까지 대기.
+    // 호출마다 힙 할당 없음 (fn은 참조로 전달).
+    template<typename Fn>
+    void parallelFor(int begin, int end, Fn&& fn) {
+        if (end <= begin) return;
+        if (m_workers.empty() || end - begin < 2) {
+            fn(begin, end);
+            return;
+        }
+        using FnType = std::remove_reference_t<Fn>;
+        run(begin, end,
+            [](void* ctx, int b, int e) { (*static_cast<FnType*>(ctx))(b, e); },
+            const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+    // 하드웨어 스레드 수 (알 수 없으면 1)
+    static int hardwareThreads();
+
+private:
+    using TaskFn = void (*)(void*, int, int);
+
+    void run(int begin, int end, TaskFn call, void* ctx);
+    void executeBands();
+    void workerLoop(uint64_t seen);
+    void stopWorkers();
+
+    std::vector<std::thread> m_workers;
+    std::mutex               m_mutex;
+    std::condition_variable  m_wake;   // 새 작업 / 종료 알림
+    std::condition_variable  m_done;   // 작업자 완료 알림
+
+    // 현재 작업 (m_mutex로 게시, 실행 중에는 읽기 전용)
+    TaskFn           m_call       = nullptr;
+    void*            m_ctx        = nullptr;
+    int              m_begin      = 0;
+    int              m_end        = 0;
+    int              m_bandSize   = 1;
+    int              m_bandCount  = 0;
+    std::atomic<int> m_nextBand{ 0 };
+    int              m_pending    = 0;  // 아직 끝나지 않은 작업자 수
+    uint64_t         m_generation = 0;
+    bool             m_stop       = false;
+};
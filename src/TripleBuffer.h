@@ -0,0 +1,57 @@
+//
+// TripleBuffer.h
+// WaterColorSimulation
+//
+// 단일 생산자/단일 소비자 무잠금 삼중 버퍼. 생산자는 back 슬롯을 채운 뒤 publish()로
+// 중간 슬롯과 교환하고, 소비자는 update()로 새로 게시된 중간 슬롯을 front와 교환한다.
+// 양쪽 모두 기다리지 않으며 소비자는 항상 완성된 최신 값만 본다 (중간 값은 건너뜀).
+//
+// 슬롯 인덱스 교환은 원자 변수 하나(m_middle)로만 이루어지고, 그 하위 비트는 인덱스,
+// k_fresh 비트는 "소비자가 아직 가져가지 않은 게시"를 뜻한다.
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+
+template<typename T>
+class TripleBuffer {
+public:
+    // 세 슬롯을 같은 값으로 채움 (생산자/소비자 스레드 시작 전에만 호출)
+    void fill(const T& value) {
+        for (T& slot : m_slots) slot = value;
+    }
+
+    // 생산자 전용: 다음에 게시할 슬롯
+    T& back() { return m_slots[m_back]; }
+
+    // 생산자 전용: back을 게시하고 이전 중간 슬롯을 새 back으로 가져옴
+    void publish() {
+        const int previous = m_middle.exchange(m_back | k_fresh, std::memory_order_acq_rel);
+        m_back = previous & k_indexMask;
+    }
+
+    // 소비자 전용: 새 게시가 있으면 front와 교환. 반환: front가 바뀌었는지
+    bool update() {
+        if (!(m_middle.load(std::memory_order_relaxed) & k_fresh)) return false;
+        const int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & k_indexMask;
+        return true;
+    }
+
+    // 소비자 전용: update()가 가져갈 새 게시가 있는지 (교환하지 않음)
+    bool pending() const { return m_middle.load(std::memory_order_seq_cst) & k_fresh; }
+
+    // 소비자 전용: 마지막으로 가져온 값 (update() 전까지 유효)
+    const T& front() const { return m_slots[m_front]; }
+
+private:
+    static constexpr int k_indexMask = 3;
+    static constexpr int k_fresh     = 4;
+
+    std::array<T, 3> m_slots{};
+
+    int m_back = 0;                              // 생산자 소유
+    alignas(64) std::atomic<int> m_middle{ 1 };  // 공유
+    alignas(64) int m_front = 2;                 // 소비자 소유
+};
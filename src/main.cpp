@@ -4,15 +4,34 @@
 //
 // 진입점: GLFW/GLEW 윈도우 생성, Dear ImGui 패널 초기화, 메인 루프 실행
 //
+// 사용법:
+//   WaterColorSimulation [--size WxH]   (격자 크기, 기본 256x256, 한 변 최대 Grid::k_maxSide)
+//
 // 조작법:
 //   마우스 드래그   - 캔버스에 그리기
+//   오른쪽 드래그   - 화면 이동
+//   마우스 휠       - 커서 위치 기준 확대/축소
 //   Space          - 시뮬레이션 켜기/끄기
 //   0              - 캔버스 초기화
 //   1-8            - 표시 모드 전환
 //   9              - 안료를 French Ultramarine으로 변경
 //   위/아래 화살표  - 브러시 반경 조절
+//   P              - 프로파일러 링 버퍼를 profile.csv (시뮬레이션) / profile_render.csv로 저장
+//
+// 시뮬레이션은 SimulationThread에서 자체 속도로 돌고, 이 스레드(렌더)는 입력 수집,
+// 패널, 최신 스냅샷 그리기만 한다. 패널 편집은 SimulationSettings 복사본으로 게시.
+// 캔버스 크기는 실행 시 정하고 패널에서 바꿀 수 있다 (격자/시뮬레이션/스레드를 새로 만듦).
+// 뷰포트에는 캔버스 전체 또는 일부(CanvasView)가 보이며, 시뮬레이션 스레드는 보이는 화면 타일 중
+// 바뀐 블록의 원시 필드만 채우고 Renderer는 타일 텍스처 캐시에 바뀐 블록 사각형만 올린 뒤
+// 표시 모드 합성은 셰이더가 한다 (RenderTiles.h, Res/shader.frag).
 //
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
 
 // GLEW는 다른 OpenGL 헤더보다 먼저 포함해야 함
@@ -25,75 +44,251 @@
 #include "../third_party/imgui/imgui_impl_opengl3.h"
 
 #include "Grid.h"
+#include "InputQueue.h"
 #include "Simulation.h"
+#include "SimulationThread.h"
 #include "Renderer.h"
 #include "KubelkaMunk.h"
+#include "Profiler.h"
 
 // --- 상수 --------------------------------------------------------------------
-static constexpr int  GRID_W      = 256;   // 시뮬레이션 격자 너비
-static constexpr int  GRID_H      = 256;   // 시뮬레이션 격자 높이
+static constexpr int  GRID_W      = 256;   // 기본 시뮬레이션 격자 너비 (--size로 변경)
+static constexpr int  GRID_H      = 256;   // 기본 시뮬레이션 격자 높이
 static constexpr int  CANVAS_SIZE = 1024;  // 캔버스 뷰포트 크기
 static constexpr int  PANEL_W     = 260;   // ImGui 패널 너비
 static constexpr int  WINDOW_W    = CANVAS_SIZE + PANEL_W;
 static constexpr int  WINDOW_H    = CANVAS_SIZE;
+static constexpr const char* PROFILE_CSV        = "profile.csv";         // P 키 덤프 경로 (시뮬레이션)
+static constexpr const char* PROFILE_RENDER_CSV = "profile_render.csv";  // P 키 덤프 경로 (렌더)
+
+// 시뮬레이션이 유휴가 된 뒤 이벤트 대기로 들어가기 전에 더 그릴 프레임 수
+// (ImGui는 입력 한 번의 결과를 반영하는 데 한두 프레임이 더 필요)
+static constexpr int  IDLE_SETTLE_FRAMES = 3;
+
+static constexpr float ZOOM_STEP           = 1.25f;         // 휠 한 칸의 배율
+static constexpr float MIN_CELLS_PER_PIXEL = 1.0f / 16.0f;  // 최대 확대 (셀 하나 = 16픽셀)
+
+// 패널의 캔버스 크기 선택지 (정사각형 한 변)
+static constexpr int  CANVAS_SIDES[] = { 256, 512, 1024, 2048, 4096, 8192, 16384 };
+
+// --- 캔버스 세션 -----------------------------------------------------------------
+
+// 한 캔버스 크기에 묶인 격자/시뮬레이션/시뮬레이션 스레드. 크기를 바꾸면 통째로 새로 만든다.
+struct CanvasSession {
+    Grid             grid;
+    Simulation       sim;
+    SimulationThread thread;
+
+    CanvasSession(int w, int h, const SimulationParams& params, InputQueue& input)
+        : grid(w, h), sim(grid, params), thread(sim, grid, input) {}
+};
 
 // --- 애플리케이션 상태 (GLFW 콜백에서 사용) ----------------------------------
 struct AppState {
-    Grid*        grid        = nullptr;
-    Simulation*  sim         = nullptr;
-    PigmentInfo  pigment;
-    DisplayMode  displayMode  = DisplayMode::Composite;
-    bool         isSimulating = false;
-    bool         isMouseDown  = false;
-    float        mouseNormX   = 0.0f;
-    float        mouseNormY   = 0.0f;
+    std::unique_ptr<CanvasSession> session;
+    SimulationThread*  simThread = nullptr;  // session->thread
+    Renderer*          renderer  = nullptr;
+    SimulationSettings settings;   // 패널/키가 편집하는 설정 (바뀌면 simThread에 게시)
+    SimulationSettings published;  // 마지막으로 게시한 설정
+    glm::ivec2         canvas{ 0 };         // 현재 격자 크기
+    glm::ivec2         requestedCanvas{ 0 };  // 패널에서 요청한 새 크기 (프레임 끝에 적용)
+    bool               panning = false;      // 오른쪽 드래그 중
+    glm::vec2          panFrom{ 0.0f };      // 직전 커서 위치 (픽셀)
+    PigmentInfo        pigment;
+    InputQueue         input;      // 콜백 → 시뮬레이션 포인터 이벤트 (Simulation::consumeInput)
+    Profiler           profiler;   // 렌더 스레드 단계 (Render, Gui, Frame)
 };
 
 static AppState g_app;
 
 // --- GLFW 콜백 ---------------------------------------------------------------
 
-static void onMouseButton(GLFWwindow* /*win*/, int button, int action, int /*mods*/) {
-    if (ImGui::GetIO().WantCaptureMouse) return;  // ImGui가 먼저 처리
-    if (button == GLFW_MOUSE_BUTTON_LEFT)
-        g_app.isMouseDown = (action == GLFW_PRESS);
+// 뷰포트 픽셀을 캔버스 좌표로 옮겨 격자 크기 기준 [0,1]로 정규화한 포인터 이벤트를 입력 큐에 넣음
+static void pushPointerEvent(InputEvent::Type type, double x, double y) {
+    const glm::vec2 cell = g_app.settings.view.toCanvas(glm::vec2(x, y));
+    InputEvent event;
+    event.type  = type;
+    event.time  = inputClock();
+    event.normX = cell.x / static_cast<float>(g_app.canvas.x);
+    event.normY = cell.y / static_cast<float>(g_app.canvas.y);
+    g_app.input.push(event);
+    if (g_app.simThread) g_app.simThread->wake();
+}
+
+// 뷰를 바꾸고 캔버스 중심이 화면을 벗어나지 않게 맞춤
+static void setView(const CanvasView& view) {
+    g_app.settings.view = view.clampedTo(g_app.canvas.x, g_app.canvas.y);
+}
+
+static void onMouseButton(GLFWwindow* win, int button, int action, int /*mods*/) {
+    if (button == GLFW_MOUSE_BUTTON_RIGHT) {
+        double x = 0.0, y = 0.0;
+        glfwGetCursorPos(win, &x, &y);
+        g_app.panning = action == GLFW_PRESS && !ImGui::GetIO().WantCaptureMouse;
+        g_app.panFrom = glm::vec2(x, y);
+        return;
+    }
+    if (button != GLFW_MOUSE_BUTTON_LEFT) return;
+    // 누름은 ImGui가 먼저 처리, 뗌은 스트로크가 남지 않도록 항상 전달
+    if (action == GLFW_PRESS && ImGui::GetIO().WantCaptureMouse) return;
+
+    double x = 0.0, y = 0.0;
+    glfwGetCursorPos(win, &x, &y);
+    pushPointerEvent(action == GLFW_PRESS ? InputEvent::Type::Press : InputEvent::Type::Release,
+                     x, y);
 }
 
 static void onCursorPos(GLFWwindow* /*win*/, double x, double y) {
+    if (g_app.panning) {
+        const glm::vec2 cursor(x, y);
+        setView(g_app.settings.view.panned(cursor - g_app.panFrom));
+        g_app.panFrom = cursor;
+    }
     if (ImGui::GetIO().WantCaptureMouse) return;
-    // 캔버스 영역 기준 [0,1]로 정규화
-    g_app.mouseNormX = static_cast<float>(x) / static_cast<float>(CANVAS_SIZE);
-    g_app.mouseNormY = static_cast<float>(y) / static_cast<float>(CANVAS_SIZE);
+    pushPointerEvent(InputEvent::Type::Move, x, y);
+}
+
+// 휠: 커서 아래 캔버스 점을 고정한 채 확대/축소 (전체가 보이는 배율의 2배까지 축소)
+static void onScroll(GLFWwindow* win, double /*dx*/, double dy) {
+    if (ImGui::GetIO().WantCaptureMouse) return;
+    double x = 0.0, y = 0.0;
+    glfwGetCursorPos(win, &x, &y);
+
+    const CanvasView& view = g_app.settings.view;
+    const CanvasView  fit  = CanvasView::fit(g_app.canvas.x, g_app.canvas.y, view.viewport);
+    const float       cpp  = std::clamp(view.cellsPerPixel * std::pow(ZOOM_STEP, static_cast<float>(-dy)),
+                                        MIN_CELLS_PER_PIXEL, std::max(1.0f, 2.0f * fit.cellsPerPixel));
+    setView(view.zoomedAt(glm::vec2(x, y), cpp));
 }
 
 static void onKey(GLFWwindow* /*win*/, int key, int /*scancode*/, int action, int /*mods*/) {
     if (action != GLFW_PRESS) return;
 
     switch (key) {
-    case GLFW_KEY_0:     g_app.grid->init(); break;
+    case GLFW_KEY_0:
+        g_app.simThread->requestReset();
+        break;
     case GLFW_KEY_SPACE:
-        g_app.isSimulating = !g_app.isSimulating;
-        std::cout << "Simulation: " << (g_app.isSimulating ? "ON" : "OFF") << "\n";
+        g_app.settings.running = !g_app.settings.running;
+        std::cout << "Simulation: " << (g_app.settings.running ? "ON" : "OFF") << "\n";
         break;
     // 1-8: 표시 모드 전환
-    case GLFW_KEY_1: g_app.displayMode = DisplayMode::Composite;      break;
-    case GLFW_KEY_2: g_app.displayMode = DisplayMode::Water;          break;
-    case GLFW_KEY_3: g_app.displayMode = DisplayMode::Saturation;     break;
-    case GLFW_KEY_4: g_app.displayMode = DisplayMode::VelocityX;      break;
-    case GLFW_KEY_5: g_app.displayMode = DisplayMode::WetMask;        break;
-    case GLFW_KEY_6: g_app.displayMode = DisplayMode::Evaporation;    break;
-    case GLFW_KEY_7: g_app.displayMode = DisplayMode::Deposit;        break;
-    case GLFW_KEY_8: g_app.displayMode = DisplayMode::SurfacePigment; break;
-    case GLFW_KEY_9: g_app.pigment.setFrenchUltramarine();            break;
-    case GLFW_KEY_UP:   g_app.sim->params.brushRadius++;              break;
+    case GLFW_KEY_1: g_app.settings.displayMode = DisplayMode::Composite;      break;
+    case GLFW_KEY_2: g_app.settings.displayMode = DisplayMode::Water;          break;
+    case GLFW_KEY_3: g_app.settings.displayMode = DisplayMode::Saturation;     break;
+    case GLFW_KEY_4: g_app.settings.displayMode = DisplayMode::VelocityX;      break;
+    case GLFW_KEY_5: g_app.settings.displayMode = DisplayMode::WetMask;        break;
+    case GLFW_KEY_6: g_app.settings.displayMode = DisplayMode::Evaporation;    break;
+    case GLFW_KEY_7: g_app.settings.displayMode = DisplayMode::Deposit;        break;
+    case GLFW_KEY_8: g_app.settings.displayMode = DisplayMode::SurfacePigment; break;
+    case GLFW_KEY_9: g_app.pigment.setFrenchUltramarine();                     break;
+    case GLFW_KEY_P:
+        g_app.simThread->requestProfileDump(PROFILE_CSV);
+        if (g_app.profiler.dumpCsv(PROFILE_RENDER_CSV))
+            std::cout << "Profile written to " << PROFILE_RENDER_CSV << "\n";
+        break;
+    case GLFW_KEY_UP:   g_app.settings.params.brushRadius++;                   break;
     case GLFW_KEY_DOWN:
-        if (g_app.sim->params.brushRadius > 2)
-            --g_app.sim->params.brushRadius;
+        if (g_app.settings.params.brushRadius > 2)
+            --g_app.settings.params.brushRadius;
         break;
     default: break;
     }
 }
 
+// --- ImGui 프로파일러 ---------------------------------------------------------
+
+// 단계별 min/avg/p99 표와 프레임 시간 그래프.
+// 렌더 단계는 이 스레드의 profiler, 시뮬레이션 단계는 스냅샷에 담긴 통계를 사용.
+static void renderProfilerSection(const Profiler& profiler, const SimulationSnapshot& snap) {
+    if (!ImGui::CollapsingHeader("Profiler [P=CSV]")) return;
+
+    const Profiler::Stats frame = profiler.stats(ProfileStage::Frame);
+    char overlay[32];
+    std::snprintf(overlay, sizeof(overlay), "avg %.2f ms", frame.avg);
+    ImGui::PlotLines("##FrameTime", profiler.history(ProfileStage::Frame),
+                     Profiler::k_historySize, profiler.historyOffset(),
+                     overlay, 0.0f, std::max(33.3f, frame.p99), ImVec2(-1, 60));
+
+    const ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp;
+    if (ImGui::BeginTable("##Stages", 4, flags)) {
+        ImGui::TableSetupColumn("Stage (ms)", ImGuiTableColumnFlags_WidthStretch, 2.2f);
+        ImGui::TableSetupColumn("min");
+        ImGui::TableSetupColumn("avg");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableHeadersRow();
+        for (int i = 0; i < Profiler::k_stageCount; ++i) {
+            const ProfileStage stage = static_cast<ProfileStage>(i);
+            Profiler::Stats    st    = profiler.stats(stage);
+            if (st.frames == 0) st = snap.profile[i];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(profileStageName(stage));
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", st.min);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", st.avg);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", st.p99);
+        }
+        ImGui::EndTable();
+    }
+}
+
+// --- ImGui 캔버스 크기/뷰 ------------------------------------------------------
+
+// 크기 선택(적용은 프레임 끝, CanvasSession을 새로 만듦)과 뷰 배율.
+// 합성/업로드는 보이는 영역만이라 큰 캔버스도 렌더 비용은 뷰포트 크기에 비례.
+static void renderCanvasSection(const SimulationSnapshot& snap) {
+    if (!ImGui::CollapsingHeader("Canvas")) return;
+
+    static int sideIdx = -1;
+    if (sideIdx < 0) {
+        sideIdx = 0;
+        for (int i = 0; i < IM_ARRAYSIZE(CANVAS_SIDES); ++i)
+            if (CANVAS_SIDES[i] <= std::max(g_app.canvas.x, g_app.canvas.y)) sideIdx = i;
+    }
+    char label[32];
+    std::snprintf(label, sizeof(label), "%d x %d", CANVAS_SIDES[sideIdx], CANVAS_SIDES[sideIdx]);
+    if (ImGui::BeginCombo("Size", label)) {
+        for (int i = 0; i < IM_ARRAYSIZE(CANVAS_SIDES); ++i) {
+            std::snprintf(label, sizeof(label), "%d x %d", CANVAS_SIDES[i], CANVAS_SIDES[i]);
+            if (ImGui::Selectable(label, i == sideIdx)) sideIdx = i;
+        }
+        ImGui::EndCombo();
+    }
+    // 할당 없이 배치만 재서 예상 격자 메모리 표시
+    const int side = CANVAS_SIDES[sideIdx];
+    ImGui::Text("Grid memory: %.0f MB", Grid::memoryReport(side, side).total / double(1 << 20));
+    if (ImGui::Button("Apply Size (clears canvas)", ImVec2(-1, 0)))
+        g_app.requestedCanvas = glm::ivec2(side, side);
+
+    const CanvasView& view = g_app.settings.view;
+    ImGui::Text("Canvas %d x %d  zoom %.3g px/cell", g_app.canvas.x, g_app.canvas.y,
+                1.0f / view.cellsPerPixel);
+    // 현재 격자의 실제 아레나 (init 이후 바뀌지 않으므로 시뮬레이션 스레드와 경합 없음)
+    if (g_app.session) {
+        const Grid& grid = g_app.session->grid;
+        ImGui::Text("Arena %.0f MB  huge pages %s", grid.arenaBytes() / double(1 << 20),
+                    grid.usesHugePages() ? "on" : "off");
+    }
+    ImGui::Text("Tiles L%d: %d visible, %.1fk texels updated", snap.tileLevel,
+                static_cast<int>(snap.tiles.size()), snap.texelsUpdated / 1000.0f);
+    ImGui::Text("Uploaded %d tiles (%.1f KB)  cached %d / %d", g_app.renderer->uploadedTiles(),
+                g_app.renderer->uploadedBytes() / 1024.0, g_app.renderer->cachedTiles(),
+                Renderer::k_maxCachedTiles);
+    // 업로드 형식: 채널당 4 / 2바이트, RGBA 층 4바이트 (바꾸면 타일 캐시를 비우고 다시 올림)
+    const TileFormat formats[] = { TileFormat::Float16, TileFormat::Srgb8, TileFormat::Float32 };
+    const TileFormat current   = g_app.renderer->tileFormat();
+    if (ImGui::BeginCombo("Upload", tileFormatName(current))) {
+        for (TileFormat format : formats)
+            if (ImGui::Selectable(tileFormatName(format), format == current))
+                g_app.renderer->setTileFormat(format);
+        ImGui::EndCombo();
+    }
+    if (ImGui::Button("Fit", ImVec2(80, 0)))
+        setView(CanvasView::fit(g_app.canvas.x, g_app.canvas.y, view.viewport));
+    ImGui::SameLine();
+    if (ImGui::Button("1:1", ImVec2(80, 0)))
+        setView(view.zoomedTo(1.0f));
+}
+
 // --- ImGui 파라미터 패널 -----------------------------------------------------
 
 static void renderControlPanel(SimulationParams& p) {
@@ -107,24 +302,63 @@ static void renderControlPanel(SimulationParams& p) {
                            | ImGuiWindowFlags_NoCollapse;
 
     ImGui::Begin("Controls", nullptr, flags);
+    const SimulationSnapshot& snap = g_app.simThread->snapshot();
 
     ImGui::Text("WaterColor Simulation");
     ImGui::Separator();
 
-    if (ImGui::Button(g_app.isSimulating ? "Stop  [Space]" : "Start [Space]", ImVec2(-1, 0)))
-        g_app.isSimulating = !g_app.isSimulating;
+    if (ImGui::Button(g_app.settings.running ? "Stop  [Space]" : "Start [Space]", ImVec2(-1, 0)))
+        g_app.settings.running = !g_app.settings.running;
     if (ImGui::Button("Reset [0]", ImVec2(-1, 0)))
-        g_app.grid->init();
+        g_app.simThread->requestReset();
 
     ImGui::Separator();
-    ImGui::SliderInt("Speed",        &p.speedMultiplier, 1, 20);
+    ImGui::SliderFloat("Time Scale", &p.timeScale, 0.25f, 8.0f);
+    {
+        int stepping = static_cast<int>(p.timeStepping);
+        if (ImGui::Combo("Time Step", &stepping, "Fixed\0Adaptive (CFL)\0"))
+            p.timeStepping = static_cast<TimeStepping>(stepping);
+    }
+    if (p.timeStepping == TimeStepping::Fixed)
+        ImGui::SliderFloat("Fixed dt", &p.fixedDt, 1.0f / 240.0f, 1.0f / 15.0f, "%.4f s");
+    else
+        ImGui::SliderFloat("CFL",      &p.cflTarget, 0.1f, 2.0f);
+    ImGui::SliderFloat("Step Budget", &p.stepBudgetMs, 0.0f, 33.0f,
+                       p.stepBudgetMs > 0.0f ? "%.1f ms" : "off");
+    if (p.stepBudgetMs <= 0.0f)
+        ImGui::SliderInt("Max Substeps", &p.maxSubsteps, 1, 32);
+    ImGui::Text("Steps %d  dt %.4f s  |v|max %.2f", snap.substeps, snap.stepDt,
+                snap.stats.maxVelocity);
+    ImGui::Text("Step %.2f ms  debt %.3f s", snap.stepCostMs, snap.debt);
+    ImGui::SliderInt("Advect Speed", &p.speedMultiplier, 1, 20);
     ImGui::SliderInt("Brush Radius", &p.brushRadius,     2, 40);
+    ImGui::SliderFloat("Brush Softness", &p.brushSoftness, 0.0f, 1.0f);
+    ImGui::SliderFloat("Brush Spacing",  &p.brushSpacing,  0.05f, 1.0f);
+    ImGui::SliderInt("Threads",      &p.threadCount,     1, ThreadPool::hardwareThreads());
+    ImGui::Text("Active tiles: %d / %d", snap.activeTiles, snap.tileCount);
+    ImGui::Text("Sim loop: %.0f Hz  (params v%llu)%s", snap.loopHz,
+                static_cast<unsigned long long>(snap.paramsVersion), snap.idle ? "  idle" : "");
 
     ImGui::Separator();
     ImGui::Text("Fluid Parameters");
     ImGui::SliderFloat("KappaV",   &p.velocityViscosity,  0.0f, 1.0f);
     ImGui::SliderFloat("KappaW",   &p.waterViscosity,     0.0f, 1.0f);
     ImGui::SliderFloat("KappaP",   &p.pigmentViscosity,   0.0f, 5.0f);
+    {
+        int solver = static_cast<int>(p.diffusionSolver);
+        if (ImGui::Combo("Solver", &solver, "Red-Black\0Multigrid\0"))
+            p.diffusionSolver = static_cast<DiffusionSolver>(solver);
+    }
+    ImGui::SliderFloat("Tolerance", &p.diffusionTolerance, 1e-6f, 1e-2f, "%.0e",
+                       ImGuiSliderFlags_Logarithmic);
+    ImGui::SliderInt("Max Iter",   &p.diffusionMaxIter,   1, 200);
+    {
+        const SimulationStats& st = snap.stats;
+        ImGui::Text("Iterations  V %d  W %d  P %d",
+                    st.diffuseIterations[static_cast<int>(DiffuseField::Velocity)],
+                    st.diffuseIterations[static_cast<int>(DiffuseField::Water)],
+                    st.diffuseIterations[static_cast<int>(DiffuseField::Pigment)]);
+    }
 
     ImGui::Separator();
     ImGui::Text("Capillary Layer");
@@ -146,9 +380,9 @@ static void renderControlPanel(SimulationParams& p) {
         "1: Composite", "2: Water", "3: Saturation", "4: Velocity X",
         "5: Wet Mask",  "6: Evaporation", "7: Deposit", "8: Surface Pigment"
     };
-    int modeIdx = static_cast<int>(g_app.displayMode);
+    int modeIdx = static_cast<int>(g_app.settings.displayMode);
     if (ImGui::Combo("##Mode", &modeIdx, modeNames, 8))
-        g_app.displayMode = static_cast<DisplayMode>(modeIdx);
+        g_app.settings.displayMode = static_cast<DisplayMode>(modeIdx);
 
     ImGui::Separator();
     ImGui::Text("Pigment [9=Ultramarine]");
@@ -162,12 +396,75 @@ static void renderControlPanel(SimulationParams& p) {
     if (ImGui::Button("Interference Lilac",   ImVec2(-1, 0))) g_app.pigment.setInterferenceLilac();
     if (ImGui::Button("French Ultramarine",   ImVec2(-1, 0))) g_app.pigment.setFrenchUltramarine();
 
+    ImGui::Separator();
+    renderCanvasSection(snap);
+    renderProfilerSection(g_app.profiler, snap);
+
     ImGui::End();
 }
 
+// --- 설정 게시 ----------------------------------------------------------------
+
+// version을 제외한 설정 비교 (SimulationParams는 산술/열거형 멤버만 가짐)
+static bool settingsChanged(const SimulationSettings& a, const SimulationSettings& b) {
+    return std::memcmp(&a.params, &b.params, sizeof(SimulationParams)) != 0
+        || a.running != b.running
+        || a.displayMode != b.displayMode
+        || a.pigmentColor != b.pigmentColor
+        || a.view != b.view;
+}
+
+// --- 캔버스 열기 ----------------------------------------------------------------
+
+// 기존 세션을 정리하고 w × h 격자로 새 세션을 만들어 시작. 뷰는 캔버스 전체에 맞춤.
+// 큰 캔버스 둘을 동시에 잡지 않도록 기존 것을 먼저 해제한다. 반환: 할당 성공 여부
+static bool openCanvas(int w, int h) {
+    if (g_app.session) g_app.session->thread.stop();
+    g_app.simThread = nullptr;
+    g_app.session.reset();
+
+    auto session = std::make_unique<CanvasSession>(w, h, g_app.settings.params, g_app.input);
+    if (!session->sim.initCanvas()) return false;
+
+    g_app.canvas           = glm::ivec2(w, h);
+    g_app.settings.params  = session->sim.params;
+    g_app.settings.view    = CanvasView::fit(w, h, glm::ivec2(CANVAS_SIZE, CANVAS_SIZE));
+    g_app.settings.version = g_app.published.version + 1;
+    g_app.published        = g_app.settings;
+    g_app.session          = std::move(session);
+    g_app.simThread        = &g_app.session->thread;
+    g_app.simThread->setRenderWake([] { glfwPostEmptyEvent(); });
+    g_app.simThread->start(g_app.published);
+    std::cout << "Canvas: " << w << "x" << h << "\n";
+    return true;
+}
+
+// "WxH" 파싱 (한 변 3 ~ Grid::k_maxSide)
+static bool parseSize(const char* text, int& w, int& h) {
+    const char* x = std::strchr(text, 'x');
+    if (!x) return false;
+    w = std::atoi(text);
+    h = std::atoi(x + 1);
+    return w >= 3 && h >= 3 && w <= Grid::k_maxSide && h <= Grid::k_maxSide;
+}
+
 // --- 진입점 ------------------------------------------------------------------
 
-int main() {
+int main(int argc, char** argv) {
+    int gridW = GRID_W, gridH = GRID_H;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (!parseSize(argv[++i], gridW, gridH)) {
+                std::cerr << "[ERROR] Invalid --size (expected WxH, 3 to " << Grid::k_maxSide
+                          << " per side): " << argv[i] << "\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--size WxH]\n";
+            return 1;
+        }
+    }
+
     // GLFW 초기화
     if (!glfwInit()) {
         std::cerr << "[FATAL] glfwInit failed\n";
@@ -201,6 +498,7 @@ int main() {
     // (ImGui_ImplGlfw_InitForOpenGL이 기존 콜백을 저장하고 체이닝하므로 순서 중요)
     glfwSetMouseButtonCallback(window, onMouseButton);
     glfwSetCursorPosCallback  (window, onCursorPos);
+    glfwSetScrollCallback     (window, onScroll);
     glfwSetKeyCallback        (window, onKey);
 
     // Dear ImGui 초기화
@@ -210,55 +508,84 @@ int main() {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init("#version 410");
 
-    // 시뮬레이션 초기화
-    Grid         grid(GRID_W, GRID_H);
-    SimulationParams params;
-    Simulation   sim(grid, params);
-    Renderer     renderer;
-
-    g_app.grid = &grid;
-    g_app.sim  = &sim;
+    // 시뮬레이션 초기화 (시작 후 sim/grid는 시뮬레이션 스레드만 접근)
+    Renderer renderer;
+    g_app.renderer = &renderer;
     g_app.pigment.setQuinacridoneMagenta();  // 기본 안료
-
-    grid.init();
+    g_app.settings.pigmentColor = g_app.pigment.colorW;
+    if (!openCanvas(gridW, gridH)) {
+        glfwTerminate();
+        return 1;
+    }
     renderer.init("res/shader.vert", "res/shader.frag");
 
-    float lastTime = static_cast<float>(glfwGetTime());
-
-    // 메인 루프
+    // 메인 루프 (렌더 스레드).
+    // 시뮬레이션이 유휴이고 IDLE_SETTLE_FRAMES 프레임 동안 바뀐 것이 없으면 폴링 대신
+    // 다음 이벤트(입력, 또는 시뮬레이션 스레드의 새 스냅샷)까지 대기
+    int quietFrames = 0;
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
-
-        float currentTime = static_cast<float>(glfwGetTime());
-        float dt          = currentTime - lastTime;
-        lastTime          = currentTime;
+        if (quietFrames >= IDLE_SETTLE_FRAMES && g_app.simThread->beginRenderWait()) {
+            glfwWaitEvents();
+            quietFrames = 0;
+        }
 
-        // 브러시 적용 (현재 선택된 안료 색상 전달)
-        sim.applyBrush(g_app.mouseNormX, g_app.mouseNormY, g_app.isMouseDown,
-                       g_app.pigment.colorW);
+        g_app.profiler.beginFrame();
+        ScopedTimer frameTimer(g_app.profiler, ProfileStage::Frame);
 
-        // 시뮬레이션 진행
-        if (g_app.isSimulating) {
-            for (int i = 0; i < sim.params.speedMultiplier; ++i)
-                sim.step(dt);
-        }
+        glfwPollEvents();
 
-        // 렌더 버퍼 갱신 후 캔버스 영역에 렌더링
-        sim.updateRenderBuffer(g_app.displayMode);
+        // 최신 스냅샷의 바뀐 타일을 올리고 현재 뷰로 그림 (새 스냅샷이 없으면 이전 것).
+        // 스냅샷은 만들 때의 뷰 기준 타일을 담지만 그리기는 캐시에서 현재 뷰로 (이동 직후에도 즉시 반응).
+        SimulationThread& simThread = *g_app.simThread;
+        const bool fresh = simThread.acquireSnapshot();
+        bool       quiet = !fresh && simThread.snapshot().idle;
         glViewport(0, 0, CANVAS_SIZE, CANVAS_SIZE);
-        renderer.render(grid.renderBuffer.data(), GRID_W, GRID_H);
+        {
+            ScopedTimer t(g_app.profiler, ProfileStage::Render);
+            const SimulationSnapshot& snap = simThread.snapshot();
+            renderer.render(snap.tiles, snap.tileLayers.data(), snap.tileMode, g_app.settings.view,
+                            g_app.canvas.x, g_app.canvas.y);
+        }
 
         // ImGui 프레임
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
-        renderControlPanel(sim.params);
-        ImGui::Render();
-        glViewport(0, 0, WINDOW_W, WINDOW_H);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            ScopedTimer t(g_app.profiler, ProfileStage::Gui);
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
+            renderControlPanel(g_app.settings.params);
+            ImGui::Render();
+            glViewport(0, 0, WINDOW_W, WINDOW_H);
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+
+        // 패널/키 입력으로 설정이 바뀌었으면 새 버전으로 게시
+        g_app.settings.pigmentColor = g_app.pigment.colorW;
+        if (settingsChanged(g_app.settings, g_app.published)) {
+            g_app.settings.version = g_app.published.version + 1;
+            g_app.published        = g_app.settings;
+            simThread.publishSettings(g_app.published);
+            quiet = false;
+        }
+
+        // 패널에서 요청한 크기로 캔버스 교체 (실패하면 이전 크기로 복구)
+        if (g_app.requestedCanvas != glm::ivec2(0)) {
+            const glm::ivec2 previous = g_app.canvas;
+            const glm::ivec2 size     = g_app.requestedCanvas;
+            g_app.requestedCanvas     = glm::ivec2(0);
+            if (size != previous && !openCanvas(size.x, size.y)
+                && !openCanvas(previous.x, previous.y)) {
+                std::cerr << "[FATAL] Failed to restore canvas\n";
+                break;
+            }
+            renderer.clearTiles();  // 새 세션의 타일 버전은 처음부터 다시 매겨짐
+            quiet = false;
+        }
 
         glfwSwapBuffers(window);
+        quietFrames = quiet ? quietFrames + 1 : 0;
     }
+    g_app.session.reset();  // 시뮬레이션 스레드 종료 후 격자 해제
 
     // 정리
     ImGui_ImplOpenGL3_Shutdown();
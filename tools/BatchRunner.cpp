@@ -0,0 +1,177 @@
+//
+// BatchRunner.cpp
+// WaterColorSimulation
+//
+// 헤드리스 배치 실행기: 윈도우/V-Sync/GPU 없이 스트로크 스크립트를 재생하고
+// 최종 합성 결과(캔버스 전체)를 이미지로 저장 (렌더 팜용)
+//
+// 사용법:
+//   watercolor_batch --script strokes.txt --size 1024x1024 --steps 600 --out out.ppm
+//
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Grid.h"
+#include "ImageWriter.h"
+#include "KubelkaMunk.h"
+#include "Simulation.h"
+#include "StrokeScript.h"
+
+namespace {
+
+struct Options {
+    std::string scriptPath;
+    std::string outPath   = "out.ppm";
+    std::string profilePath;        // 비어 있지 않으면 스텝별 타이밍 CSV 저장
+    int         width     = 256;
+    int         height    = 256;
+    int         steps     = 0;      // 스크립트 실행 후 추가로 진행할 스텝 수
+    float       dt        = 1.0f / 60.0f;
+    int         speed     = 1;      // SimulationParams::speedMultiplier
+    int         threads   = 0;      // SimulationParams::threadCount (0 = 하드웨어 스레드 수)
+    float       tolerance = SimulationParams().diffusionTolerance;
+    DiffusionSolver solver = DiffusionSolver::RedBlack;
+    SimdLevel   simd      = SimdLevel::Auto;
+    DisplayMode mode      = DisplayMode::Composite;
+};
+
+void printUsage(const char* argv0) {
+    std::cerr
+        << "Usage: " << argv0 << " --script FILE [options]\n"
+        << "  --script FILE   stroke script (see StrokeScript.h)\n"
+        << "  --size WxH      grid size (default 256x256)\n"
+        << "  --steps N       extra simulation steps after the script (default 0)\n"
+        << "  --dt SECONDS    time step per simulation step (default 1/60)\n"
+        << "  --speed N       speed multiplier used by advection (default 1)\n"
+        << "  --threads N     worker threads for the simulation kernels (default: all cores)\n"
+        << "  --tolerance R   relative residual that stops the diffusion solver (default 1e-4)\n"
+        << "  --solver NAME   diffusion solver: redblack or multigrid (default redblack)\n"
+        << "  --simd LEVEL    kernel implementation: auto, scalar, sse4.2 or avx2 (default auto)\n"
+        << "  --mode 1-8      display mode written to the image (default 1: Composite)\n"
+        << "  --out FILE      output image, .ppm or .pfm (default out.ppm)\n"
+        << "  --profile FILE  write per-step substep timings of the last steps as CSV\n";
+}
+
+bool parseSize(const char* text, int& w, int& h) {
+    const char* x = std::strchr(text, 'x');
+    if (!x) return false;
+    w = std::atoi(text);
+    h = std::atoi(x + 1);
+    return w >= 3 && h >= 3 && w <= Grid::k_maxSide && h <= Grid::k_maxSide;
+}
+
+bool parseSimdLevel(const char* text, SimdLevel& level) {
+    for (SimdLevel l : { SimdLevel::Auto, SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2 }) {
+        if (std::strcmp(text, simdLevelName(l)) == 0) {
+            level = l;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg  = argv[i];
+        const char*       next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "-h" || arg == "--help") return false;
+        if (!next) {
+            std::cerr << "[ERROR] Missing value for " << arg << "\n";
+            return false;
+        }
+        ++i;
+        if      (arg == "--script")  opt.scriptPath  = next;
+        else if (arg == "--out")     opt.outPath     = next;
+        else if (arg == "--profile") opt.profilePath = next;
+        else if (arg == "--steps")   opt.steps       = std::atoi(next);
+        else if (arg == "--dt")      opt.dt          = static_cast<float>(std::atof(next));
+        else if (arg == "--speed")   opt.speed       = std::atoi(next);
+        else if (arg == "--threads") opt.threads     = std::atoi(next);
+        else if (arg == "--tolerance") opt.tolerance = static_cast<float>(std::atof(next));
+        else if (arg == "--solver") {
+            if      (std::strcmp(next, "redblack")  == 0) opt.solver = DiffusionSolver::RedBlack;
+            else if (std::strcmp(next, "multigrid") == 0) opt.solver = DiffusionSolver::Multigrid;
+            else {
+                std::cerr << "[ERROR] --solver must be redblack or multigrid\n";
+                return false;
+            }
+        } else if (arg == "--simd") {
+            if (!parseSimdLevel(next, opt.simd)) {
+                std::cerr << "[ERROR] --simd must be auto, scalar, sse4.2 or avx2\n";
+                return false;
+            }
+        } else if (arg == "--mode") {
+            const int m = std::atoi(next);
+            if (m < 1 || m > 8) {
+                std::cerr << "[ERROR] --mode must be 1-8\n";
+                return false;
+            }
+            opt.mode = static_cast<DisplayMode>(m - 1);
+        } else if (arg == "--size") {
+            if (!parseSize(next, opt.width, opt.height)) {
+                std::cerr << "[ERROR] Invalid --size (expected WxH, 3 to " << Grid::k_maxSide
+                          << " per side): " << next << "\n";
+                return false;
+            }
+        } else {
+            std::cerr << "[ERROR] Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    if (opt.scriptPath.empty()) {
+        std::cerr << "[ERROR] --script is required\n";
+        return false;
+    }
+    return opt.steps >= 0 && opt.speed >= 1;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    StrokeScript script;
+    if (!script.load(opt.scriptPath)) return 1;
+
+    Grid             grid(opt.width, opt.height);
+    SimulationParams params;
+    params.speedMultiplier = opt.speed;
+    params.threadCount     = opt.threads;
+    params.diffusionTolerance = opt.tolerance;
+    params.diffusionSolver    = opt.solver;
+    params.simdLevel          = opt.simd;
+    Simulation       sim(grid, params);
+    PigmentInfo      pigment;
+    pigment.setQuinacridoneMagenta();  // GUI와 동일한 기본 안료
+
+    if (!sim.initCanvas()) return 1;
+    script.run(sim, pigment, opt.dt);
+    for (int i = 0; i < opt.steps; ++i) {
+        sim.profiler.beginFrame();  // 스텝 하나 = 프로파일러 프레임 하나
+        sim.step(opt.dt);
+    }
+
+    const RenderRegion region = RenderRegion::full(grid.width, grid.height);
+    std::vector<float> image(region.floats());
+    sim.updateRenderBuffer(opt.mode, region, image.data());
+    if (!writeImage(opt.outPath, image.data(), grid.width, grid.height))
+        return 1;
+    if (!opt.profilePath.empty() && !sim.profiler.dumpCsv(opt.profilePath))
+        return 1;
+
+    std::cout << "Wrote " << opt.outPath << " (" << grid.width << "x" << grid.height
+              << ", kernels: " << simdLevelName(sim.simdLevel()) << ")\n";
+    std::cout << "Diffusion iterations (last step):";
+    for (int f = 0; f < SimulationStats::k_fields; ++f)
+        std::cout << " " << diffuseFieldName(static_cast<DiffuseField>(f))
+                  << "=" << sim.stats().diffuseIterations[f];
+    std::cout << "\n";
+    return 0;
+}
@@ -0,0 +1,381 @@
+//
+// Benchmark.cpp
+// WaterColorSimulation
+//
+// Simulation 서브스텝별 마이크로 벤치마크.
+// 격자 크기 × 캔버스 상태(건조/부분 젖음/전체 젖음) × 커널 조합마다
+// 셀당 ns와 유효 대역폭(GB/s)을 CSV로 출력.
+//
+// 사용법:
+//   watercolor_bench [--sizes 256,1024,2048,4096] [--canvas dry,partial,wet]
+//                    [--reps N] [--threads N] [--simd auto,scalar,sse4.2,avx2]
+//                    [--report kernels|memory] [--out results.csv]
+//
+// 대역폭은 커널이 셀당 읽고 쓰는 필드 바이트의 명목값(k_kernels 표)으로 계산한다.
+// 캐시 재사용은 고려하지 않으므로 실제 DRAM 트래픽이 아닌 비교용 지표이다.
+// 활성 타일만 도는 커널은 셀당 ns와 대역폭을 실제 방문 셀(활성 타일 수 × 타일 면적)로
+// 나누고, 방문 셀 수는 visited_cells 열에 함께 출력한다 (건조 캔버스에서는 방문 셀이 0이라 두 값도 0).
+//
+// --report memory는 커널을 돌리지 않고 크기별 격자 아레나 구역 크기(MB)만 출력한다
+// (할당하지 않으므로 메모리가 부족한 크기도 계산 가능). scratch_peak는 작은 젖은 캔버스에서
+// 한 스텝 동안 실제로 동시에 빌린 평면 수 (격자 크기와 무관, scratch_planes 이하여야 함).
+// baseline_temps_mb는 같은 배치로 계산한 풀 도입 전 필드별 임시 평면 9장 + 블러 벡터,
+// saved_mb는 그 값과 scratch_mb의 차이.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "GaussianBlur.h"
+#include "Grid.h"
+#include "Simulation.h"
+
+namespace {
+
+enum class Canvas { Dry, Partial, Wet };
+
+const char* canvasName(Canvas c) {
+    switch (c) {
+    case Canvas::Dry:     return "dry";
+    case Canvas::Partial: return "partial";
+    case Canvas::Wet:     return "wet";
+    }
+    return "?";
+}
+
+// 캔버스 상태 구성. Partial은 중앙 원판(면적 약 20%)만 젖은 상태. 격자 할당 실패 시 false.
+bool prepareCanvas(Grid& grid, Canvas canvas) {
+    if (!grid.init()) return false;
+    if (canvas == Canvas::Dry) return true;
+
+    const glm::vec3 color(0.55f, 0.16f, 0.27f);
+    const float     cx = 0.5f * grid.width;
+    const float     cy = 0.5f * grid.height;
+    const float     r  = 0.25f * std::min(grid.width, grid.height);
+
+    for (int y = 1; y < grid.height - 1; ++y) {
+        for (int x = 1; x < grid.width - 1; ++x) {
+            if (canvas == Canvas::Partial) {
+                const float dx = x - cx, dy = y - cy;
+                if (dx * dx + dy * dy >= r * r) continue;
+            }
+            const std::ptrdiff_t i = grid.index(x, y);
+            // 수위에 기울기를 줘서 속도/이류 커널이 실제 일을 하도록 함
+            grid.water[i]       = 2.0f + 0.5f * grid.heightMap[i];
+            grid.saturation[i]  = 0.35f;
+            grid.wetAreaMask[i] = 1.0f;
+            grid.pigment[i]     = 0.2f;
+            grid.surfaceColor.set(i, color * 0.2f);
+            grid.velocity.set(i, glm::vec2(0.3f, -0.2f) * grid.heightMap[i]);
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+// Simulation의 private 서브스텝에 접근하는 벤치마크 진입점
+class SimulationBenchmark {
+public:
+    struct Kernel {
+        const char* name;
+        double      bytesPerCell;  // 명목 읽기+쓰기 바이트
+        std::function<void(Simulation&, Grid&)> run;
+        bool        fullCanvas = false;  // 활성 타일과 무관하게 캔버스 전체를 도는 커널
+    };
+
+    // params 변경(스레드 수, 커널 구현 수준)을 step() 없이 반영
+    static void applyParams(Simulation& sim) { sim.syncExecutionParams(); }
+
+    // 지금까지 동시에 빌린 최대 scratch 평면 수
+    static int scratchPeak(const Simulation& sim) { return sim.m_scratch.peak(); }
+
+    static std::vector<Kernel> kernels(float dt) {
+        const double F = sizeof(float), V2 = sizeof(glm::vec2), V3 = sizeof(glm::vec3);
+        std::vector<Kernel> k;
+
+        // advect: vel 읽기 + 필드 샘플 + 임시 평면 쓰기 (반영은 호출자 몫이라 매 반복 같은 입력)
+        k.push_back({ "advect<float>", V2 + F + F,
+            [dt](Simulation& s, Grid& g) {
+                Scratch<FloatPlane> out(s.m_scratch);
+                s.advect<1>(planesOf(g.pigment), planesOf(*out),
+                            g.velocity.plane(0), g.velocity.plane(1), dt); } });
+        k.push_back({ "advect<vec2>", V2 + V2 + V2,
+            [dt](Simulation& s, Grid& g) {
+                Scratch<Vec2Field> out(s.m_scratch);
+                s.advect<2>(g.velocity.planes(), out->planes(),
+                            g.velocity.plane(0), g.velocity.plane(1), dt); } });
+        k.push_back({ "advect<vec3>", V2 + V3 + V3,
+            [dt](Simulation& s, Grid& g) {
+                Scratch<Vec3Field> out(s.m_scratch);
+                s.advect<3>(g.surfaceColor.planes(), out->planes(),
+                            g.velocity.plane(0), g.velocity.plane(1), dt); } });
+
+        // diffuse: 우변 복사 + 반복마다 (mask + 우변 읽기 + 필드 읽기/쓰기).
+        // 반복 횟수는 수렴에 따라 달라지므로 명목값은 1회 반복 기준.
+        k.push_back({ "diffuse<float>", 2 * F + (F + F + 2 * F),
+            [dt](Simulation& s, Grid& g) {
+                Scratch<FloatPlane> rhs(s.m_scratch);
+                s.diffuse<1>(s.params.waterViscosity, planesOf(g.water), planesOf(*rhs),
+                             g.wetAreaMask.data(), dt, DiffuseField::Water); } });
+        k.push_back({ "diffuse<vec2>", 2 * V2 + (F + V2 + 2 * V2),
+            [dt](Simulation& s, Grid& g) {
+                Scratch<Vec2Field> rhs(s.m_scratch);
+                s.diffuse<2>(s.params.velocityViscosity, g.velocity.planes(), rhs->planes(),
+                             g.wetAreaMask.data(), dt, DiffuseField::Velocity); } });
+        k.push_back({ "diffuse<vec3>", 2 * V3 + (F + V3 + 2 * V3),
+            [dt](Simulation& s, Grid& g) {
+                Scratch<Vec3Field> rhs(s.m_scratch);
+                s.diffuse<3>(s.params.pigmentViscosity, g.surfaceColor.planes(), rhs->planes(),
+                             g.wetAreaMask.data(), dt, DiffuseField::Pigment); } });
+        // 멀티그리드: 평활 4회 + 잔차/제한/연장 (조대 수준 비용은 명목값에서 제외)
+        k.push_back({ "diffuse<vec3>/multigrid", 2 * V3 + 4 * (F + V3 + 2 * V3) + (F + 2 * V3),
+            [dt](Simulation& s, Grid& g) {
+                Scratch<Vec3Field> rhs(s.m_scratch);
+                s.params.diffusionSolver = DiffusionSolver::Multigrid;
+                s.diffuse<3>(s.params.pigmentViscosity, g.surfaceColor.planes(), rhs->planes(),
+                             g.wetAreaMask.data(), dt, DiffuseField::Pigment);
+                s.params.diffusionSolver = DiffusionSolver::RedBlack; } });
+        // 안료 농도 + 색상 4성분 융합 확산 (updatePigment 전반부)
+        k.push_back({ "diffuse<pigment>", 2 * (F + V3) + (F + (F + V3) + 2 * (F + V3)),
+            [dt](Simulation& s, Grid& g) {
+                Scratch<FloatPlane> rhsPigment(s.m_scratch);
+                Scratch<Vec3Field>  rhsColor(s.m_scratch);
+                Vec3Field&          color = g.surfaceColor;
+                const PlaneSet<4>   field = { g.pigment.data(),
+                                              color.plane(0), color.plane(1), color.plane(2) };
+                const PlaneSet<4>   rhs   = { rhsPigment->data(),
+                                              rhsColor->plane(0), rhsColor->plane(1), rhsColor->plane(2) };
+                s.diffuse<4>(s.params.pigmentViscosity, field, rhs,
+                             g.wetAreaMask.data(), dt, DiffuseField::Pigment); } });
+
+        // waterAdvect: 필드, mask, vel 읽기 + 임시 평면 쓰기
+        k.push_back({ "waterAdvect<float>", F + F + V2 + F,
+            [dt](Simulation& s, Grid& g) {
+                Scratch<FloatPlane> out(s.m_scratch);
+                s.waterAdvect(g.water.data(), out->data(),
+                              g.velocity.plane(0), g.velocity.plane(1),
+                              g.wetAreaMask.data(), dt); } });
+
+        // 안료 단계 전체: 확산 + 이류 (updatePigment)
+        k.push_back({ "updatePigment", 0.0,
+            [dt](Simulation& s, Grid&) { s.updatePigment(dt); } });
+
+        // 융합 안료 이류: (vel, mask, 농도, 색상 샘플) 읽기 + 임시 평면 쓰기 + 필드로 복사
+        k.push_back({ "advectPigment", V2 + F + F + V3 + 3 * (F + V3),
+            [dt](Simulation& s, Grid& g) {
+                s.advectPigment(g.velocity.plane(0), g.velocity.plane(1),
+                                g.wetAreaMask.data(), dt); } });
+
+        k.push_back({ "addHeightDifferenceVelocity", F + 2 * V2,
+            [](Simulation& s, Grid&) { s.addHeightDifferenceVelocity(); } });
+        k.push_back({ "applyBoundaryConditions", F + V2,
+            [](Simulation& s, Grid&) { s.applyBoundaryConditions(); } });
+        // flowOutward: mask 복사 + 블러(3패스 × 가로/세로) + 셀 갱신
+        k.push_back({ "flowOutward", 2 * F + 3 * 4 * F + (4 * F + 3 * F),
+            [](Simulation& s, Grid&) { s.flowOutward(); } });
+        k.push_back({ "updateSurfaceLayer", 5 * F + 4 * F + 2 * V3 * 2,
+            [dt](Simulation& s, Grid&) { s.updateSurfaceLayer(dt); } });
+        // 흡수 + 확산(포화도/용량 읽기 + 임시 평면 쓰기) + 반영/마스크 갱신
+        k.push_back({ "updateCapillaryLayer", 6 * F + 3 * F + 4 * F,
+            [](Simulation& s, Grid&) { s.updateCapillaryLayer(); } });
+
+        k.push_back({ "fastGaussianBlur", 3 * 4 * F,
+            [](Simulation& s, Grid& g) {
+                Scratch<FloatPlane> inPlane(s.m_scratch);
+                Scratch<FloatPlane> outPlane(s.m_scratch);
+                float* in  = inPlane->data();
+                float* out = outPlane->data();
+                fastGaussianBlur(in, out, g.width, g.height, 15.0f); }, true });
+        // 합성: 캔버스 전체를 반복마다 재사용하는 출력 버퍼로 (종이는 heightMap에서 유도)
+        auto image = std::make_shared<std::vector<float>>();
+        k.push_back({ "updateRenderBuffer", 2 * F + 2 * V3 + F + 3 * F,
+            [image](Simulation& s, Grid& g) {
+                const RenderRegion region = RenderRegion::full(g.width, g.height);
+                image->resize(region.floats());
+                s.updateRenderBuffer(DisplayMode::Composite, region, image->data()); }, true });
+
+        // 브러시: 반경 10 도장 하나, 캔버스 폭 20%를 가로지르는 스트로크 한 구간 (ms로 비교)
+        k.push_back({ "stampBrush", 0.0,
+            [](Simulation& s, Grid&) { s.stampBrush(0.5f, 0.5f, glm::vec3(0.55f, 0.16f, 0.27f)); } });
+        k.push_back({ "applyBrush/stroke", 0.0,
+            [](Simulation& s, Grid&) {
+                const glm::vec3 color(0.55f, 0.16f, 0.27f);
+                s.applyBrush(0.4f, 0.5f, true, color);
+                s.applyBrush(0.6f, 0.5f, true, color);
+                s.applyBrush(0.6f, 0.5f, false, color); } });
+
+        k.push_back({ "step", 0.0,
+            [dt](Simulation& s, Grid&) { s.step(dt); } });
+        return k;
+    }
+};
+
+namespace {
+
+struct Options {
+    std::vector<int>    sizes    = { 256, 1024, 2048, 4096 };
+    std::vector<Canvas> canvases = { Canvas::Dry, Canvas::Partial, Canvas::Wet };
+    int                 reps     = 5;
+    int                 threads  = 1;   // 기본은 단일 스레드 (커널 자체 비용 측정)
+    std::vector<SimdLevel> simd  = { SimdLevel::Auto };
+    bool                memory   = false;  // --report memory
+    std::string         outPath;   // 비어 있으면 stdout
+};
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> out;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i], val = argv[i + 1];
+        if (arg == "--sizes") {
+            opt.sizes.clear();
+            for (const std::string& s : splitList(val)) opt.sizes.push_back(std::atoi(s.c_str()));
+        } else if (arg == "--canvas") {
+            opt.canvases.clear();
+            for (const std::string& s : splitList(val)) {
+                if      (s == "dry")     opt.canvases.push_back(Canvas::Dry);
+                else if (s == "partial") opt.canvases.push_back(Canvas::Partial);
+                else if (s == "wet")     opt.canvases.push_back(Canvas::Wet);
+                else return false;
+            }
+        } else if (arg == "--reps") {
+            opt.reps = std::max(1, std::atoi(val.c_str()));
+        } else if (arg == "--threads") {
+            opt.threads = std::max(0, std::atoi(val.c_str()));
+        } else if (arg == "--simd") {
+            opt.simd.clear();
+            for (const std::string& s : splitList(val)) {
+                bool found = false;
+                for (SimdLevel l : { SimdLevel::Auto, SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2 }) {
+                    if (s == simdLevelName(l)) { opt.simd.push_back(l); found = true; }
+                }
+                if (!found) return false;
+            }
+        } else if (arg == "--report") {
+            if      (val == "kernels") opt.memory = false;
+            else if (val == "memory")  opt.memory = true;
+            else return false;
+        } else if (arg == "--out") {
+            opt.outPath = val;
+        } else {
+            return false;
+        }
+    }
+    if (argc % 2 == 0) return false;  // 값이 빠진 옵션
+    for (int s : opt.sizes) if (s < 16) return false;
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--sizes 256,1024,2048,4096] [--canvas dry,partial,wet]"
+                     " [--reps N] [--threads N] [--simd auto,scalar,sse4.2,avx2]"
+                     " [--report kernels|memory] [--out FILE]\n";
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!opt.outPath.empty()) {
+        file.open(opt.outPath);
+        if (!file.is_open()) {
+            std::cerr << "[ERROR] Cannot write " << opt.outPath << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = opt.outPath.empty() ? std::cout : file;
+
+    if (opt.memory) {
+        const double mb = 1.0 / (1 << 20);
+
+        Grid             probe(64, 64);
+        SimulationParams params;
+        Simulation       sim(probe, params);
+        if (!prepareCanvas(probe, Canvas::Wet)) return 1;
+        sim.refreshActiveTiles();
+        sim.step(1.0f / 60.0f);
+        const int peak = SimulationBenchmark::scratchPeak(sim);
+
+        out << "size,paper_mb,scratch_mb,baseline_temps_mb,saved_mb,scratch_planes,scratch_peak,state_mb,total_mb\n";
+        for (int size : opt.sizes) {
+            const Grid::MemoryReport r = Grid::memoryReport(size, size);
+            const double saved = static_cast<double>(r.baselineTemps) - static_cast<double>(r.scratch);
+            out << size << "," << r.paper * mb << "," << r.scratch * mb << ","
+                << r.baselineTemps * mb << "," << saved * mb << ","
+                << Grid::k_scratchPlanes << "," << peak << "," << r.state * mb << "," << r.total * mb << "\n";
+        }
+        return 0;
+    }
+
+    out << "size,canvas,kernel,threads,simd,reps,min_ms,median_ms,visited_cells,ns_per_cell,gb_per_s\n";
+
+    const float dt = 1.0f / 60.0f;
+    using Clock    = std::chrono::steady_clock;
+
+    for (int size : opt.sizes) {
+        Grid             grid(size, size);
+        SimulationParams params;
+        params.threadCount = opt.threads;
+        Simulation       sim(grid, params);
+        const double     cells = static_cast<double>(size) * size;
+        const double     tileArea = double(ActiveTiles::k_tileSize) * ActiveTiles::k_tileSize;
+
+        // 커널 구현 수준 × 캔버스 조합
+        std::vector<std::pair<SimdLevel, Canvas>> runs;
+        for (SimdLevel simd : opt.simd)
+            for (Canvas canvas : opt.canvases) runs.emplace_back(simd, canvas);
+
+        for (const auto& [simd, canvas] : runs) {
+            sim.params.simdLevel = simd;
+            SimulationBenchmark::applyParams(sim);
+            for (const auto& kernel : SimulationBenchmark::kernels(dt)) {
+                // 커널마다 동일한 초기 상태에서 시작 (반복 중 상태 변화는 허용)
+                if (!prepareCanvas(grid, canvas)) return 1;
+                sim.refreshActiveTiles();
+                // 가장자리 타일은 잘리므로 전체 셀 수를 넘지 않게
+                const double visited = kernel.fullCanvas ? cells
+                    : std::min(cells, sim.activeTiles().activeCount() * tileArea);
+                kernel.run(sim, grid);  // 워밍업
+
+                std::vector<double> ms;
+                for (int r = 0; r < opt.reps; ++r) {
+                    const auto t0 = Clock::now();
+                    kernel.run(sim, grid);
+                    const auto t1 = Clock::now();
+                    ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+                }
+                std::sort(ms.begin(), ms.end());
+                const double minMs    = ms.front();
+                const double medianMs = ms[ms.size() / 2];
+                const double nsCell   = visited > 0.0 ? medianMs * 1e6 / visited : 0.0;
+                const double gbs      = kernel.bytesPerCell > 0.0
+                    ? kernel.bytesPerCell * visited / (medianMs * 1e-3) / 1e9 : 0.0;
+
+                out << size << "," << canvasName(canvas) << "," << kernel.name << ","
+                    << sim.params.threadCount << "," << simdLevelName(sim.simdLevel()) << "," << opt.reps << "," << minMs << "," << medianMs << ","
+                    << visited << "," << nsCell << "," << gbs << "\n";
+                out.flush();
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,257 @@
+//
+// RenderCheck.cpp
+// WaterColorSimulation
+//
+// 헤드리스 렌더 일치 검사: 윈도우 없이 EGL(surfaceless) 컨텍스트를 만들어
+// 표시 모드 × 타일 업로드 형식마다 Renderer + shader.frag로 화면 타일을 그리고,
+// 읽어 온 픽셀을 CPU 합성(Simulation::updateRenderBuffer)과 8비트 코드 단위로 비교.
+// 허용 오차: Float32/Float16 1코드, Srgb8 2코드 (sRGB 인코딩 왕복 오차).
+// 하나라도 넘으면 종료 코드 1 (CI/Mesa llvmpipe에서 실행 가능).
+//
+// 사용법:
+//   watercolor_render_check [--size 520x450] [--steps 30] [--shaders Res]
+//
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Grid.h"
+#include "Renderer.h"
+#include "Simulation.h"
+
+namespace {
+
+struct Options {
+    std::string shaderDir = WATERCOLOR_SHADER_DIR;
+    int         width     = 520;   // 타일(256) 배수가 아닌 크기로 가장자리 타일까지 검사
+    int         height    = 450;
+    int         steps     = 30;    // 붓질 후 추가로 진행할 스텝 수
+};
+
+void printUsage(const char* argv0) {
+    std::cerr
+        << "Usage: " << argv0 << " [options]\n"
+        << "  --size WxH      grid size, at most " << Renderer::k_maxCachedTiles
+        << " level-0 tiles (default 520x450)\n"
+        << "  --steps N       simulation steps after the brush strokes (default 30)\n"
+        << "  --shaders DIR   directory holding shader.vert and shader.frag (default: source Res/)\n";
+}
+
+int tileCount(int w, int h) {
+    return ((w + k_tileTexels - 1) / k_tileTexels) * ((h + k_tileTexels - 1) / k_tileTexels);
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg  = argv[i];
+        const char*       next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "-h" || arg == "--help") return false;
+        if (!next) {
+            std::cerr << "[ERROR] Missing value for " << arg << "\n";
+            return false;
+        }
+        ++i;
+        if      (arg == "--shaders") opt.shaderDir = next;
+        else if (arg == "--steps")   opt.steps     = std::atoi(next);
+        else if (arg == "--size") {
+            const char* x = std::strchr(next, 'x');
+            opt.width  = std::atoi(next);
+            opt.height = x ? std::atoi(x + 1) : 0;
+            if (opt.width < 3 || opt.height < 3
+                || tileCount(opt.width, opt.height) > Renderer::k_maxCachedTiles) {
+                std::cerr << "[ERROR] Invalid --size (expected WxH, at most "
+                          << Renderer::k_maxCachedTiles << " tiles of " << k_tileTexels
+                          << "): " << next << "\n";
+                return false;
+            }
+        } else {
+            std::cerr << "[ERROR] Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    return opt.steps >= 0;
+}
+
+// 화면 없는 OpenGL 코어 컨텍스트를 현재 스레드에 연결 (Mesa surfaceless 플랫폼 우선)
+bool makeHeadlessContext() {
+    EGLDisplay display = EGL_NO_DISPLAY;
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay)
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        std::cerr << "[ERROR] EGL display initialisation failed\n";
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "[ERROR] EGL has no desktop OpenGL API\n";
+        return false;
+    }
+
+    const EGLint configAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig    config  = nullptr;
+    EGLint       configs = 0;
+    eglChooseConfig(display, configAttribs, &config, 1, &configs);
+
+    // main.cpp와 같은 4.1 코어 프로필 (config 없는 컨텍스트는 EGL_KHR_no_config_context)
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 1,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, configs > 0 ? config : EGL_NO_CONFIG_KHR,
+                                          EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT
+        || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        std::cerr << "[ERROR] Could not create an OpenGL 4.1 core context\n";
+        return false;
+    }
+
+    glewExperimental = GL_TRUE;
+    const GLenum glew = glewInit();
+    // GLX용으로 빌드된 GLEW는 GL 함수를 모두 로드한 뒤 X 디스플레이가 없다며 실패 → 그대로 사용
+    if (glew != GLEW_OK && glew != GLEW_ERROR_NO_GLX_DISPLAY) {
+        std::cerr << "[ERROR] glewInit failed\n";
+        return false;
+    }
+    return true;
+}
+
+const char* displayModeName(DisplayMode mode) {
+    switch (mode) {
+    case DisplayMode::Composite:      return "composite";
+    case DisplayMode::Water:          return "water";
+    case DisplayMode::Saturation:     return "saturation";
+    case DisplayMode::VelocityX:      return "velocity_x";
+    case DisplayMode::WetMask:        return "wet_mask";
+    case DisplayMode::Evaporation:    return "evaporation";
+    case DisplayMode::Deposit:        return "deposit";
+    case DisplayMode::SurfacePigment: return "surface_pigment";
+    }
+    return "?";
+}
+
+// 형식별 허용 오차 (8비트 코드)
+int tolerance(TileFormat format) {
+    return format == TileFormat::Srgb8 ? 2 : 1;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (!makeHeadlessContext()) return 1;
+
+    const int w = opt.width;
+    const int h = opt.height;
+
+    // 뷰포트 = 캔버스 (화면 픽셀 하나 = 셀 하나, 수준 0 타일)
+    GLuint framebuffer = 0, colorBuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "[ERROR] Framebuffer incomplete\n";
+        return 1;
+    }
+    glViewport(0, 0, w, h);
+
+    // 여러 색의 붓질 뒤 스텝을 진행해 물/속도/침착이 모두 0이 아닌 캔버스를 만듦
+    Grid             grid(w, h);
+    SimulationParams params;
+    Simulation       sim(grid, params);
+    if (!sim.initCanvas()) return 1;
+    const glm::vec3 colors[] = { { 0.1f, 0.3f, 0.8f }, { 0.55f, 0.16f, 0.27f }, { 0.2f, 0.6f, 0.1f } };
+    for (int k = 0; k < 12; ++k) {
+        sim.stampBrush(0.2f + 0.05f * k, 0.3f + 0.03f * k, colors[k % 3]);
+        sim.step(0.05f);
+    }
+    for (int k = 0; k < opt.steps; ++k) sim.step(0.05f);
+
+    Renderer renderer;
+    renderer.init(opt.shaderDir + "/shader.vert", opt.shaderDir + "/shader.frag");
+    if (!renderer.loaded()) return 1;
+
+    CanvasView view;
+    view.viewport = { w, h };
+
+    const RenderRegion         full = RenderRegion::full(w, h);
+    std::vector<float>         reference(full.floats());
+    std::vector<unsigned char> pixels(static_cast<size_t>(4) * w * h);
+    std::vector<TileImage>     tiles;
+    std::vector<float>         layers;
+    uint64_t                   version = 0;
+    bool                       pass    = true;
+
+    std::cout << "format,mode,max_diff,tolerance,result\n";
+    for (TileFormat format : { TileFormat::Float32, TileFormat::Float16, TileFormat::Srgb8 }) {
+        renderer.setTileFormat(format);
+        for (int m = 0; m < 8; ++m) {
+            const DisplayMode mode   = static_cast<DisplayMode>(m);
+            const TileLayout  layout = TileLayout::of(mode);
+
+            // SimulationThread::renderInto와 같이 보이는 타일마다 층을 채우되 버전은 매번 새로
+            ++version;
+            tiles.clear();
+            forEachVisibleTile(view, w, h, 0, [&](const TileKey& key) {
+                TileImage tile;
+                tile.key     = key;
+                tile.version = version;
+                tile.blocks.fill(version);
+                tiles.push_back(tile);
+            });
+            layers.assign(tiles.size() * layout.floats, 0.0f);
+            for (size_t t = 0; t < tiles.size(); ++t)
+                sim.updateTileLayers(mode, tiles[t].key.region(), layers.data() + t * layout.floats,
+                                     0, 0, true);
+
+            // 프레임당 업로드 상한이 있으므로 모든 타일이 올라갈 때까지 다시 그림
+            do {
+                renderer.render(tiles, layers.data(), mode, view, w, h);
+            } while (renderer.uploadedTiles() > 0);
+            glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+            sim.updateRenderBuffer(mode, full, reference.data());
+            int worst = 0;
+            for (int y = 0; y < h; ++y) {
+                // 읽은 픽셀은 아래 행부터
+                const unsigned char* row = &pixels[static_cast<size_t>(4) * (h - 1 - y) * w];
+                for (int x = 0; x < w; ++x) {
+                    for (int c = 0; c < 3; ++c) {
+                        const float v    = std::clamp(reference[3 * (static_cast<size_t>(y) * w + x) + c],
+                                                      0.0f, 1.0f);
+                        const int   code = static_cast<int>(std::lround(v * 255.0f));
+                        worst = std::max(worst, std::abs(code - row[4 * x + c]));
+                    }
+                }
+            }
+            const bool ok = worst <= tolerance(format);
+            pass = pass && ok;
+            std::cout << tileFormatName(format) << "," << displayModeName(mode) << "," << worst << ","
+                      << tolerance(format) << "," << (ok ? "ok" : "FAIL") << "\n";
+        }
+    }
+
+    if (const GLenum error = glGetError(); error != GL_NO_ERROR) {
+        std::cerr << "[ERROR] OpenGL error 0x" << std::hex << error << "\n";
+        return 1;
+    }
+    return pass ? 0 : 1;
+}